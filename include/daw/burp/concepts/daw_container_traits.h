@@ -16,7 +16,9 @@
 
 #include <array>
 #include <cstddef>
+#include <deque>
 #include <iterator>
+#include <memory>
 #include <type_traits>
 
 namespace daw::burp {
@@ -38,9 +40,70 @@ namespace daw::burp {
 			template<typename T>
 			inline constexpr bool is_container_v = container_traits<T>::value;
 
+			/// @brief Can the type be written like a container.  Ranges with a size but no way to be
+			/// constructed, e.g. views, can be written but not read back as themselves
+			template<typename T>
+			inline constexpr bool is_writable_range_v =
+			  is_container_v<T> or container_detect::is_sized_range_v<T>;
+
 			template<typename T>
 			inline constexpr bool is_contiguous_container_v =
 			  daw::is_detected_v<container_detect::is_contiguous_container_test, T>;
+
+			/// @brief Concept for containers that store their elements in a sequence of contiguous
+			/// blocks.  Specializations have a static for_each_segment( container, f ) that calls
+			/// f( pointer, count ) for each run of contiguous elements in order, allowing trivial
+			/// elements to be copied a block at a time.
+			template<typename T, typename = void>
+			struct segmented_container_traits : std::false_type {};
+
+			/// @brief The blocks of a deque are not exposed, runs of adjacent element addresses are
+			/// found by walking the iterators instead
+			template<typename T, typename Allocator>
+			struct segmented_container_traits<std::deque<T, Allocator>> : std::true_type {
+				template<typename Deque, typename Function>
+				static void for_each_segment( Deque &container, Function &&func ) {
+					auto first = std::begin( container );
+					auto const last = std::end( container );
+					while( first != last ) {
+						auto *const run = std::addressof( *first );
+						std::size_t count = 1;
+						++first;
+						while( first != last and std::addressof( *first ) == run + count ) {
+							++count;
+							++first;
+						}
+						func( run, count );
+					}
+				}
+			};
+
+			template<typename T>
+			inline constexpr bool is_segmented_container_v = segmented_container_traits<T>::value;
+
+			/// @brief How the elements of node based containers, those without random access
+			/// iterators, are traversed when writing.  Each element is prefetched prefetch_distance
+			/// nodes before it is visited.  When batch_size is non-zero the addresses of batch_size
+			/// nodes are gathered and prefetched first and then the batch is visited, instead.
+			/// Specialize to tune for a container type, a prefetch_distance and batch_size of zero
+			/// gives a plain loop.
+			template<typename T, typename = void>
+			struct node_traversal_traits {
+				static constexpr std::size_t prefetch_distance = 8;
+				static constexpr std::size_t batch_size = 0;
+			};
+
+			template<typename T>
+			inline constexpr bool is_node_container_v = [] {
+				if constexpr( is_writable_range_v<T> ) {
+					using iterator_t = decltype( std::begin( std::declval<T const &>( ) ) );
+					return not std::is_base_of_v<
+					  std::random_access_iterator_tag,
+					  typename std::iterator_traits<iterator_t>::iterator_category>;
+				} else {
+					return false;
+				}
+			}( );
 		} // namespace concepts
 	}   // namespace DAW_BURP_VER
 } // namespace daw::burp
@@ -21,7 +21,29 @@
 namespace daw::burp {
 	inline namespace DAW_BURP_VER {
 		namespace concepts {
+			/// @brief The integral type an enum is encoded as, its underlying type by default.
+			/// daw_burp_describe.h narrows Boost.Described enums to the smallest type holding the range
+			/// of their enumerators.  Specializations must be visible everywhere the enum is encoded.
+			template<typename E, typename = void>
+			struct enum_encoding {
+				using type = std::underlying_type_t<E>;
+			};
+
+			template<typename E>
+			using enum_encoding_t = typename enum_encoding<E>::type;
+
 			namespace container_detect {
+				/// Enums encoded at their full width are written as raw bytes like the fundamental
+				/// types, which also lets containers of them take the bulk path
+				template<typename T>
+				inline constexpr bool is_native_width_enum_v = [] {
+					if constexpr( std::is_enum_v<T> ) {
+						return sizeof( enum_encoding_t<T> ) == sizeof( T );
+					} else {
+						return false;
+					}
+				}( );
+
 				template<typename T>
 				using is_container_test = decltype( (void)( std::begin( std::declval<T &>( ) ) ),
 				                                    (void)( std::end( std::declval<T &>( ) ) ),
@@ -59,8 +81,10 @@ namespace daw::burp {
 				  ;
 
 				template<typename T>
-				inline constexpr bool is_fundamental_type_v =
-				  std::is_arithmetic_v<T> or is_character_type_v<T> or std::is_same_v<T, bool>;
+				inline constexpr bool is_fundamental_type_v = std::is_arithmetic_v<T> or
+				                                              is_character_type_v<T> or
+				                                              std::is_same_v<T, bool> or
+				                                              is_native_width_enum_v<T>;
 
 				template<typename, typename = void>
 				struct container_value_type {
@@ -94,6 +118,36 @@ namespace daw::burp {
 				template<typename T>
 				inline constexpr bool is_fundamental_value_type_v =
 				  container_value_type<T>::is_fundamental_type;
+
+				template<typename T>
+				using is_resizable_container_test =
+				  decltype( std::declval<T &>( ).resize( std::declval<std::size_t>( ) ) );
+
+				template<typename T>
+				inline constexpr bool is_resizable_container_v =
+				  daw::is_detected_v<is_resizable_container_test, T>;
+
+				template<typename T>
+				using is_reservable_container_test =
+				  decltype( std::declval<T &>( ).reserve( std::declval<std::size_t>( ) ) );
+
+				template<typename T>
+				inline constexpr bool is_reservable_container_v =
+				  daw::is_detected_v<is_reservable_container_test, T>;
+
+				template<typename T>
+				using has_capacity_test = decltype( std::declval<T const &>( ).capacity( ) );
+
+				template<typename T>
+				inline constexpr bool has_capacity_v = daw::is_detected_v<has_capacity_test, T>;
+
+				template<typename T>
+				using is_sized_range_test = decltype( (void)( std::begin( std::declval<T const &>( ) ) ),
+				                                      (void)( std::end( std::declval<T const &>( ) ) ),
+				                                      (void)( std::size( std::declval<T const &>( ) ) ) );
+
+				template<typename T>
+				inline constexpr bool is_sized_range_v = daw::is_detected_v<is_sized_range_test, T>;
 			} // namespace container_detect
 
 			/// @brief Concept to help deduce container types.
@@ -160,6 +160,26 @@ namespace daw::burp {
 #endif
 				}
 
+				template<typename Allocator,
+				         typename... Args,
+				         std::enable_if_t<
+				           nullable_impl::is_nullable_value_type_constructible_v<value_type, Args...>,
+				           std::nullptr_t> = nullptr>
+				nullable_type operator( )( construct_nullable_with_allocator_t,
+				                           Allocator const &alloc,
+				                           Args &&...args ) const {
+#if not defined( DAW_HAS_AGG_PAREN_INIT )
+					if constexpr( std::is_aggregate_v<value_type> and
+					              nullable_impl::is_list_constructible_v<value_type, Args...> ) {
+						return std::allocate_shared<value_type>( alloc, value_type{ DAW_FWD( args )... } );
+					} else {
+#endif
+						return std::allocate_shared<value_type>( alloc, DAW_FWD( args )... );
+#if not defined( DAW_HAS_AGG_PAREN_INIT )
+					}
+#endif
+				}
+
 				constexpr nullable_type operator( )( construct_nullable_with_empty_t ) const noexcept {
 					return nullable_type( );
 				}
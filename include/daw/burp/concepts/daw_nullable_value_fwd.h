@@ -42,6 +42,12 @@ namespace daw::burp {
 			inline constexpr auto construct_nullable_with_empty =
 			  construct_nullable_with_empty_t{ };
 
+			/// @brief Construct a value in the nullable type, allocating any storage it needs from the
+			/// supplied allocator.  Only nullable types with heap storage need to support this
+			struct construct_nullable_with_allocator_t {};
+			inline constexpr auto construct_nullable_with_allocator =
+			  construct_nullable_with_allocator_t{ };
+
 			/// @brief Readable values models an option/maybe/nullable type
 			/// @tparam T The option type
 			template<typename T, typename...>
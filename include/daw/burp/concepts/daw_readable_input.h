@@ -0,0 +1,141 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "../impl/errors.h"
+#include "../impl/version.h"
+
+#include "daw_readable_input_fwd.h"
+#include "daw_writable_output.h"
+
+#include <daw/daw_likely.h>
+#include <daw/daw_traits.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <type_traits>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace concepts {
+			namespace readable_input_details {
+				template<typename T>
+				using contiguous_input_test =
+				  decltype( (void)( std::declval<std::size_t &>( ) = std::declval<T const &>( ).size( ) ),
+				            (void)( *std::declval<T const &>( ).data( ) ),
+				            (void)( T( std::declval<T const &>( ).data( ), std::size_t{ } ) ) );
+
+				template<typename T>
+				using has_resize_test = decltype( std::declval<T &>( ).resize( std::size_t{ } ) );
+
+				template<typename T>
+				inline constexpr bool is_contiguous_input_v = [] {
+					if constexpr( daw::is_detected_v<contiguous_input_test, T> and
+					              not daw::is_detected_v<has_resize_test, T> ) {
+						using CharT = daw::remove_cvref_t<decltype( *std::declval<T const &>( ).data( ) )>;
+						return writeable_output_details::is_char_sized_character_v<CharT> or
+						       writeable_output_details::is_byte_type_v<CharT>;
+					}
+					return false;
+				}( );
+			} // namespace readable_input_details
+
+			/// @brief Specialization for span/string_view like views of a buffer.  Reading advances
+			/// the view past the consumed bytes.
+			template<typename T>
+			struct readable_input_trait<
+			  T,
+			  std::enable_if_t<readable_input_details::is_contiguous_input_v<T>>> : std::true_type {
+
+				static constexpr std::size_t size( T const &in ) noexcept {
+					return in.size( );
+				}
+
+				static inline char const *data( T const &in ) noexcept {
+					return reinterpret_cast<char const *>( in.data( ) );
+				}
+
+				static constexpr void skip( T &in, std::size_t count ) {
+					daw_burp_ensure( count <= in.size( ), daw::burp::ErrorReason::InputError );
+					in = T( in.data( ) + count, in.size( ) - count );
+				}
+
+				static constexpr bool at_end( T const &in ) noexcept {
+					return in.size( ) == 0;
+				}
+
+				static inline void read( T &in, char *dest, std::size_t count ) {
+					daw_burp_ensure( count <= in.size( ), daw::burp::ErrorReason::InputError );
+					if( count > 0 ) {
+						std::memcpy( dest, in.data( ), count );
+					}
+					in = T( in.data( ) + count, in.size( ) - count );
+				}
+			};
+
+			/// @brief Specialization for istream &
+			template<typename T>
+			struct readable_input_trait<T, std::enable_if_t<std::is_base_of_v<std::istream, T>>> :
+			  std::true_type {
+
+				static inline void read( std::istream &is, char *dest, std::size_t count ) {
+					is.read( dest, static_cast<std::streamsize>( count ) );
+					daw_burp_ensure( static_cast<bool>( is ), daw::burp::ErrorReason::InputError );
+				}
+
+				static inline bool at_end( std::istream &is ) {
+					return is.peek( ) == std::istream::traits_type::eof( );
+				}
+			};
+
+			/// @brief Specialization for FILE * streams
+			template<>
+			struct readable_input_trait<std::FILE *> : std::true_type {
+				static inline void read( std::FILE *f, char *dest, std::size_t count ) {
+					auto ret = std::fread( dest, 1, count, f );
+					daw_burp_ensure( ret == count, daw::burp::ErrorReason::InputError );
+				}
+
+				static inline bool at_end( std::FILE *f ) {
+					auto const c = std::fgetc( f );
+					if( c == EOF ) {
+						return true;
+					}
+					std::ungetc( c, f );
+					return false;
+				}
+			};
+
+#if defined( DAW_HAS_UNISTD )
+			template<>
+			struct readable_input_trait<fd_t> : std::true_type {
+				static inline void read( fd_t fd, char *dest, std::size_t count ) {
+					while( count > 0 ) {
+						auto ret = ::read( fd.value, dest, count );
+						if( ret < 0 and errno == EINTR ) {
+							continue;
+						}
+						daw_burp_ensure( ret > 0, daw::burp::ErrorReason::InputError );
+						dest += ret;
+						count -= static_cast<std::size_t>( ret );
+					}
+				}
+			};
+#endif
+
+			/// @brief Is the Readable a contiguous buffer whose bytes can be referenced in place
+			template<typename T>
+			inline constexpr bool is_contiguous_readable_input_v =
+			  readable_input_details::is_contiguous_input_v<T>;
+		} // namespace concepts
+	}   // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,63 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "../impl/version.h"
+
+#include <daw/daw_traits.h>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace concepts {
+			/// @brief Readable input models the source side of a burp stream.  Specializations must
+			/// have static void read( T &, char *, std::size_t ) that copies exactly that many bytes
+			/// and advances the input, or throws, and static bool value.  Optionally, a static void
+			/// skip( T &, std::size_t ) advances without copying and a static bool at_end( T & )
+			/// reports when there is no more data.
+			template<typename, typename = void>
+			struct readable_input_trait : std::false_type {};
+
+			template<typename T>
+			inline constexpr bool is_readable_input_type_v = readable_input_trait<T>::value;
+
+			namespace readable_input_details {
+				template<typename T>
+				using has_skip_test =
+				  decltype( readable_input_trait<T>::skip( std::declval<T &>( ), std::size_t{ } ) );
+			} // namespace readable_input_details
+
+			/// @brief Can the readable input advance without copying
+			template<typename T>
+			inline constexpr bool has_readable_input_skip_v =
+			  daw::is_detected_v<readable_input_details::has_skip_test, T>;
+
+			namespace readable_input_details {
+				template<typename T>
+				using has_at_end_test = decltype( readable_input_trait<T>::at_end( std::declval<T &>( ) ) );
+			} // namespace readable_input_details
+
+			/// @brief Can the readable input report the end of the data
+			template<typename T>
+			inline constexpr bool has_readable_input_at_end_v =
+			  daw::is_detected_v<readable_input_details::has_at_end_test, T>;
+
+			namespace readable_input_details {
+				template<typename T>
+				using has_size_test =
+				  decltype( readable_input_trait<T>::size( std::declval<T const &>( ) ) );
+			} // namespace readable_input_details
+
+			/// @brief Can the readable input report how many bytes remain.  Counts read from it are
+			/// checked against that before anything is allocated for them
+			template<typename T>
+			inline constexpr bool has_readable_input_size_v =
+			  daw::is_detected_v<readable_input_details::has_size_test, T>;
+		} // namespace concepts
+	}   // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -11,6 +11,7 @@
 #include "../impl/errors.h"
 #include "../impl/version.h"
 
+#include "daw_container_traits_fwd.h"
 #include "daw_writable_output_fwd.h"
 
 #include <daw/daw_algorithm.h>
@@ -19,11 +20,15 @@
 #include <daw/daw_likely.h>
 #include <daw/daw_span.h>
 
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <optional>
 #include <string>
 
 #if __has_include( <unistd.h> )
+#include <fcntl.h>
 #include <unistd.h>
 #define DAW_HAS_UNISTD
 #endif
@@ -99,6 +104,14 @@ namespace daw::burp {
 					*ptr = static_cast<T>( c );
 					++ptr;
 				}
+
+				static constexpr std::optional<T *> position( T *ptr ) noexcept {
+					return ptr;
+				}
+
+				static inline void patch( T *&, T *pos, char const *data, std::size_t count ) {
+					std::memcpy( pos, data, count );
+				}
 			};
 
 			/// @brief Specialization for ostream &
@@ -128,8 +141,56 @@ namespace daw::burp {
 					os.put( c );
 					daw_burp_ensure( static_cast<bool>( os ), daw::burp::ErrorReason::OutputError );
 				}
+
+				static inline std::optional<std::ostream::pos_type> position( std::ostream &os ) {
+					auto const pos = os.tellp( );
+					if( pos == std::ostream::pos_type( -1 ) ) {
+						os.clear( );
+						return std::nullopt;
+					}
+					return pos;
+				}
+
+				static inline void patch( std::ostream &os,
+				                          std::ostream::pos_type pos,
+				                          char const *data,
+				                          std::size_t count ) {
+					auto const current = os.tellp( );
+					os.seekp( pos );
+					os.write( data, static_cast<std::streamsize>( count ) );
+					// The open mode of a stream is not visible.  One opened with ios::app writes at the
+					// end whatever the position, which shows in the position once flushed
+					os.flush( );
+					bool const is_in_place =
+					  static_cast<bool>( os ) and
+					  os.tellp( ) == pos + static_cast<std::streamoff>( count );
+					os.seekp( current );
+					daw_burp_ensure( is_in_place and static_cast<bool>( os ),
+					                 daw::burp::ErrorReason::OutputError );
+				}
 			};
 
+			namespace writeable_output_details {
+				/// Writes to a descriptor opened for appending go to the end of the file whatever its
+				/// offset, so it cannot be patched
+				inline bool is_append_only( [[maybe_unused]] int fd ) noexcept {
+#if defined( DAW_HAS_UNISTD )
+					auto const flags = ::fcntl( fd, F_GETFL );
+					return flags >= 0 and ( flags & O_APPEND ) != 0;
+#else
+					return false;
+#endif
+				}
+
+				inline bool is_append_only( [[maybe_unused]] std::FILE *f ) noexcept {
+#if defined( DAW_HAS_UNISTD )
+					return is_append_only( ::fileno( f ) );
+#else
+					return false;
+#endif
+				}
+			} // namespace writeable_output_details
+
 			/// @brief Specialization for FILE * streams
 			template<>
 			struct writable_output_trait<std::FILE *> : std::true_type {
@@ -156,6 +217,26 @@ namespace daw::burp {
 					auto ret = std::fputc( c, f );
 					daw_burp_ensure( ret == c, daw::burp::ErrorReason::OutputError );
 				}
+
+				/// Files opened for appending have no position that can be patched
+				static inline std::optional<long> position( std::FILE *f ) {
+					auto const pos = std::ftell( f );
+					if( pos < 0 or writeable_output_details::is_append_only( f ) ) {
+						return std::nullopt;
+					}
+					return pos;
+				}
+
+				static inline void patch( std::FILE *f, long pos, char const *data, std::size_t count ) {
+					daw_burp_ensure( not writeable_output_details::is_append_only( f ),
+					                 daw::burp::ErrorReason::OutputError );
+					auto const current = std::ftell( f );
+					daw_burp_ensure( std::fseek( f, pos, SEEK_SET ) == 0,
+					                 daw::burp::ErrorReason::OutputError );
+					auto const ret = std::fwrite( data, 1, count, f );
+					daw_burp_ensure( ret == count and std::fseek( f, current, SEEK_SET ) == 0,
+					                 daw::burp::ErrorReason::OutputError );
+				}
 			};
 
 #if defined( DAW_HAS_UNISTD )
@@ -195,6 +276,31 @@ namespace daw::burp {
 				static inline void put( fd_t fd, char c ) {
 					return write( fd, daw::span<char>( &c, 1 ) );
 				}
+
+				/// Pipes and sockets cannot seek and have no position, nor do descriptors opened with
+				/// O_APPEND as pwrite appends to them
+				static inline std::optional<off_t> position( fd_t fd ) {
+					auto const pos = ::lseek( fd.value, 0, SEEK_CUR );
+					if( pos < 0 or writeable_output_details::is_append_only( fd.value ) ) {
+						return std::nullopt;
+					}
+					return pos;
+				}
+
+				static inline void patch( fd_t fd, off_t pos, char const *data, std::size_t count ) {
+					daw_burp_ensure( not writeable_output_details::is_append_only( fd.value ),
+					                 daw::burp::ErrorReason::OutputError );
+					while( count > 0 ) {
+						auto const ret = ::pwrite( fd.value, data, count, pos );
+						if( ret < 0 and errno == EINTR ) {
+							continue;
+						}
+						daw_burp_ensure( ret > 0, daw::burp::ErrorReason::OutputError );
+						data += ret;
+						pos += ret;
+						count -= static_cast<std::size_t>( ret );
+					}
+				}
 			};
 #endif
 
@@ -244,6 +350,14 @@ namespace daw::burp {
 					*out.data( ) = static_cast<CharT>( c );
 					out.remove_prefix( 1 );
 				}
+
+				static constexpr std::optional<CharT *> position( T const &out ) noexcept {
+					return out.data( );
+				}
+
+				static inline void patch( T &, CharT *pos, char const *data, std::size_t count ) {
+					std::memcpy( pos, data, count );
+				}
 			};
 
 			namespace writeable_output_details {
@@ -280,6 +394,19 @@ namespace daw::burp {
 					return std::numeric_limits<std::size_t>::max( );
 				}
 
+				/// Grows geometrically, an exact reserve per message would reallocate on every write
+				/// when many are appended to one container
+				static inline void reserve( Container &out, std::size_t additional ) {
+					if constexpr( container_detect::is_reservable_container_v<Container> and
+					              container_detect::has_capacity_v<Container> ) {
+						auto const needed = out.size( ) + additional;
+						auto const cap = out.capacity( );
+						if( cap < needed ) {
+							out.reserve( needed > 2U * cap ? needed : 2U * cap );
+						}
+					}
+				}
+
 				template<typename... ContiguousBytes>
 				static inline void write( Container &out, ContiguousBytes... blobs ) {
 					static_assert( sizeof...( ContiguousBytes ) > 0 );
@@ -301,6 +428,17 @@ namespace daw::burp {
 				static inline void put( Container &out, char c ) {
 					out.push_back( static_cast<CharT>( c ) );
 				}
+
+				static inline std::optional<std::size_t> position( Container const &out ) noexcept {
+					return out.size( );
+				}
+
+				static inline void patch( Container &out,
+				                          std::size_t pos,
+				                          char const *data,
+				                          std::size_t count ) {
+					std::memcpy( out.data( ) + pos, data, count );
+				}
 			};
 
 			namespace writeable_output_details {
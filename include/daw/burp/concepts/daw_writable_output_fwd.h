@@ -12,6 +12,9 @@
 
 #include <daw/daw_traits.h>
 
+#include <cstddef>
+#include <utility>
+
 namespace daw::burp {
 	inline namespace DAW_BURP_VER {
 		namespace concepts {
@@ -20,13 +23,40 @@ namespace daw::burp {
 			/// allocation/size checks Specializations must have static T write( T,
 			/// StringViews... ), static T put( T, char ), and static bool value.
 			/// StringViews work will have a .size( ) and .data( ) member function,
-			/// and have a character element type
+			/// and have a character element type.  Optionally, a static void
+			/// reserve( T &, std::size_t ) is called with the total size before
+			/// the first write.
 			template<typename, typename = void>
 			struct writable_output_trait : std::false_type {};
 
 			template<typename T>
 			inline constexpr bool is_writable_output_type_v =
 			  writable_output_trait<T>::value;
+
+			namespace writeable_output_details {
+				template<typename T>
+				using has_reserve_test = decltype( writable_output_trait<T>::reserve(
+				  std::declval<T &>( ), std::size_t{ } ) );
+			} // namespace writeable_output_details
+
+			/// @brief Can the writable output be told the size of the data ahead of time
+			template<typename T>
+			inline constexpr bool has_writable_output_reserve_v =
+			  daw::is_detected_v<writeable_output_details::has_reserve_test, T>;
+
+			namespace writeable_output_details {
+				template<typename T>
+				using has_position_test =
+				  decltype( writable_output_trait<T>::position( std::declval<T &>( ) ) );
+			} // namespace writeable_output_details
+
+			/// @brief Can bytes already written be overwritten later.  Seekable outputs have a static
+			/// std::optional<Pos> position( T & ) returning the current write position, or nullopt when
+			/// the output cannot seek at runtime (e.g. a pipe), and a static void patch( T &, Pos,
+			/// char const *, std::size_t ) that overwrites bytes at a previous position.
+			template<typename T>
+			inline constexpr bool is_seekable_writable_output_v =
+			  daw::is_detected_v<writeable_output_details::has_position_test, T>;
 		} // namespace concepts
 	}   // namespace DAW_BURP_VER
 } // namespace daw::burp
@@ -8,9 +8,12 @@
 
 #pragma once
 
+#include "impl/prefetch.h"
 #include "impl/version.h"
 
 #include "concepts/daw_container_traits.h"
+#include "concepts/daw_nullable_value.h"
+#include "concepts/daw_readable_input.h"
 #include "concepts/daw_writable_output.h"
 
 #include <daw/cpp_17.h>
@@ -19,8 +22,24 @@
 #include <daw/daw_move.h>
 #include <daw/daw_traits.h>
 
+#include <bitset>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
 #include <tuple>
+#include <utility>
+#include <vector>
+
+#if __has_include( <memory_resource> )
+#include <memory_resource>
+#if defined( __cpp_lib_memory_resource )
+#define DAW_BURP_HAS_PMR
+#endif
+#endif
 
 namespace daw::burp {
 	inline namespace DAW_BURP_VER {
@@ -33,6 +52,105 @@ namespace daw::burp {
 		template<typename T, typename = void>
 		struct generic_dto;
 
+		/// @brief Opt-in encoding for containers of variable sized elements.  The element count is
+		/// followed by a table of the end offset of each element, allowing readers and views to seek
+		/// to any element in constant time.  Offsets are 4 bytes wide unless the elements need more.
+		/// Writing measures the elements before the table, so each level of indexed_container's
+		/// nested in another adds one more pass over its elements.
+		template<typename Container>
+		struct indexed_container : Container {
+			using container_type = Container;
+			using Container::Container;
+
+			indexed_container( ) = default;
+
+			indexed_container( Container const &c )
+			  : Container( c ) {}
+
+			indexed_container( Container &&c ) noexcept(
+			  std::is_nothrow_move_constructible_v<Container> )
+			  : Container( std::move( c ) ) {}
+		};
+
+		/// @brief Opt-in encoding for containers of strings.  The element count is followed by a table
+		/// of the end offset of each string and then by all the characters in one block, replacing a
+		/// size prefix per string with one offset whose width is the smallest of 1/2/4/8 bytes that
+		/// fits.  string_table_view hands out string_views into the encoded buffer.
+		template<typename Container>
+		struct string_table : Container {
+			using container_type = Container;
+			using Container::Container;
+
+			string_table( ) = default;
+
+			string_table( Container const &c )
+			  : Container( c ) {}
+
+			string_table( Container &&c ) noexcept( std::is_nothrow_move_constructible_v<Container> )
+			  : Container( std::move( c ) ) {}
+		};
+
+		/// @brief Opt-in encoding for contiguous arrays of fundamental types, e.g. std::vector<float>.
+		/// Padding is placed before the elements so that they start a multiple of Alignment bytes
+		/// from the start of the encoding.  When the encoding starts at an address aligned to
+		/// Alignment, as a mapped file does, the elements can be used in place by aligned SIMD loads.
+		/// The padding size is recorded so readers do not need to know the offset.
+		template<typename Container, std::size_t Alignment = 64>
+		struct aligned_container : Container {
+			static_assert( Alignment > 0 and ( Alignment & ( Alignment - 1U ) ) == 0 and
+			                 Alignment <= 128,
+			               "Alignment must be a power of two no larger than 128" );
+			using container_type = Container;
+			using Container::Container;
+			static constexpr std::size_t alignment = Alignment;
+
+			aligned_container( ) = default;
+
+			aligned_container( Container const &c )
+			  : Container( c ) {}
+
+			aligned_container( Container &&c ) noexcept(
+			  std::is_nothrow_move_constructible_v<Container> )
+			  : Container( std::move( c ) ) {}
+		};
+
+		/// @brief A pair of forward iterators that is written like a container of its elements, without
+		/// copying them into one first.  Single pass ranges can be written with write_range
+		template<typename Iterator>
+		class iterator_range {
+			Iterator m_first;
+			Iterator m_last;
+			std::size_t m_size;
+
+		public:
+			static_assert( std::is_base_of_v<std::forward_iterator_tag,
+			                                 typename std::iterator_traits<Iterator>::iterator_category>,
+			               "The range is traversed once for its size and once to write it, use "
+			               "write_range for input iterators" );
+
+			using value_type = daw::remove_cvref_t<typename std::iterator_traits<Iterator>::reference>;
+
+			constexpr iterator_range( Iterator first, Iterator last )
+			  : m_first( first )
+			  , m_last( last )
+			  , m_size( static_cast<std::size_t>( std::distance( first, last ) ) ) {}
+
+			[[nodiscard]] constexpr Iterator begin( ) const {
+				return m_first;
+			}
+
+			[[nodiscard]] constexpr Iterator end( ) const {
+				return m_last;
+			}
+
+			[[nodiscard]] constexpr std::size_t size( ) const noexcept {
+				return m_size;
+			}
+		};
+
+		template<typename Iterator>
+		iterator_range( Iterator, Iterator ) -> iterator_range<Iterator>;
+
 		namespace burp_impl {
 			template<typename T>
 			using tuple_protocol_test = decltype( std::tuple_size<T>::value );
@@ -48,11 +166,122 @@ namespace daw::burp {
 				return result_t{ std::get<Is>( DAW_FWD( value ) )... };
 			}
 
+			/// Specialized by daw_burp_describe.h for types with Boost.Describe members
+			template<typename, typename = void>
+			inline constexpr bool is_boost_described_v = false;
+
+			template<typename>
+			inline constexpr bool is_indexed_container_v = false;
+
+			template<typename Container>
+			inline constexpr bool is_indexed_container_v<indexed_container<Container>> = true;
+
+			template<typename>
+			inline constexpr bool is_aligned_container_v = false;
+
+			template<typename Container, std::size_t Alignment>
+			inline constexpr bool is_aligned_container_v<aligned_container<Container, Alignment>> =
+			  true;
+
+			template<typename>
+			inline constexpr bool is_string_table_v = false;
+
+			template<typename Container>
+			inline constexpr bool is_string_table_v<string_table<Container>> = true;
+
+			/// Enums whose enum_encoding is narrower than the enum
+			template<typename T>
+			inline constexpr bool is_narrowed_enum_v = [] {
+				if constexpr( std::is_enum_v<T> ) {
+					return not concepts::container_detect::is_native_width_enum_v<T>;
+				} else {
+					return false;
+				}
+			}( );
+
+			template<typename>
+			inline constexpr bool is_bool_vector_v = false;
+
+			template<typename Allocator>
+			inline constexpr bool is_bool_vector_v<std::vector<bool, Allocator>> = true;
+
+			template<typename>
+			inline constexpr std::size_t bitset_size_v = 0;
+
+			template<std::size_t N>
+			inline constexpr std::size_t bitset_size_v<std::bitset<N>> = N;
+
+			template<typename T>
+			inline constexpr bool is_bitset_v = bitset_size_v<T> > 0;
+
+			constexpr std::size_t packed_bits_size( std::size_t bit_count ) noexcept {
+				return bit_count / 8U + ( bit_count % 8U != 0 ? 1U : 0U );
+			}
+
+			/// The smallest width that can hold the offsets of a string_table with total characters
+			constexpr std::uint8_t string_table_width( std::uint64_t total ) noexcept {
+				if( total <= std::numeric_limits<std::uint8_t>::max( ) ) {
+					return sizeof( std::uint8_t );
+				} else if( total <= std::numeric_limits<std::uint16_t>::max( ) ) {
+					return sizeof( std::uint16_t );
+				} else if( total <= std::numeric_limits<std::uint32_t>::max( ) ) {
+					return sizeof( std::uint32_t );
+				}
+				return sizeof( std::uint64_t );
+			}
+
+			template<typename UInt>
+			inline void store_table_entry_as( char *dest, std::uint64_t value ) noexcept {
+				auto const narrow = static_cast<UInt>( value );
+				std::memcpy( dest, &narrow, sizeof( UInt ) );
+			}
+
+			inline void store_table_entry( char *dest, std::uint64_t value, std::size_t width ) noexcept {
+				switch( width ) {
+				case sizeof( std::uint8_t ):
+					return store_table_entry_as<std::uint8_t>( dest, value );
+				case sizeof( std::uint16_t ):
+					return store_table_entry_as<std::uint16_t>( dest, value );
+				case sizeof( std::uint32_t ):
+					return store_table_entry_as<std::uint32_t>( dest, value );
+				default:
+					return store_table_entry_as<std::uint64_t>( dest, value );
+				}
+			}
+
+			template<typename UInt>
+			inline std::uint64_t load_table_entry_as( char const *src ) noexcept {
+				UInt result = 0;
+				std::memcpy( &result, src, sizeof( UInt ) );
+				return result;
+			}
+
+			inline std::uint64_t load_table_entry( char const *src, std::size_t width ) noexcept {
+				switch( width ) {
+				case sizeof( std::uint8_t ):
+					return load_table_entry_as<std::uint8_t>( src );
+				case sizeof( std::uint16_t ):
+					return load_table_entry_as<std::uint16_t>( src );
+				case sizeof( std::uint32_t ):
+					return load_table_entry_as<std::uint32_t>( src );
+				default:
+					return load_table_entry_as<std::uint64_t>( src );
+				}
+			}
+
+			/// Used as the encoded size of types whose encoding depends on their value
+			inline constexpr std::size_t dynamic_encoded_size = std::numeric_limits<std::size_t>::max( );
+
+			/// A size prefix with this value starts a sequence written in chunks, each a size prefix
+			/// followed by that many elements, and ended by an empty chunk
+			inline constexpr std::size_t chunked_sequence_marker =
+			  std::numeric_limits<std::size_t>::max( );
 		} // namespace burp_impl
 
 		template<typename T>
 		inline constexpr bool supports_tuple_protocol_v =
-		  daw::is_detected_v<burp_impl::tuple_protocol_test, T> and not use_boost_describe_v<T>;
+		  daw::is_detected_v<burp_impl::tuple_protocol_test, T> and
+		  not( burp_impl::is_boost_described_v<T> and use_boost_describe_v<T> );
 
 		/// @brief Tuple Protocol Types
 		template<typename T>
@@ -117,13 +346,10 @@ namespace daw::burp {
 				}
 				auto const do_visit = [&]( auto const &v ) {
 					using current_type = DAW_TYPEOF( v );
-					if constexpr( has_generic_dto_v<current_type> or
-					              concepts::is_container_v<current_type> ) {
-						visit_impl1( visitor, v );
-					} else {
-						static_assert( concepts::container_detect::is_fundamental_type_v<current_type>,
-						               "Type is not a fundamental type or is not mapped" );
+					if constexpr( concepts::container_detect::is_fundamental_type_v<current_type> ) {
 						visitor( daw::span( reinterpret_cast<char const *>( &v ), sizeof( current_type ) ) );
+					} else {
+						visit_impl1( visitor, v );
 					}
 					return true;
 				};
@@ -138,7 +364,8 @@ namespace daw::burp {
 
 			template<typename T>
 			inline constexpr bool is_contiguous_array_of_fundamental_like_types_v = [] {
-				if constexpr( not concepts::is_contiguous_container_v<T> ) {
+				if constexpr( not concepts::is_contiguous_container_v<T> or is_indexed_container_v<T> or
+				              is_aligned_container_v<T> ) {
 					return false;
 				} else if constexpr( concepts::container_detect::is_fundamental_value_type_v<T> ) {
 					return true;
@@ -152,13 +379,285 @@ namespace daw::burp {
 				}
 			}( );
 
+			/// Segmented containers of elements that are encoded as their bytes are copied a segment
+			/// at a time
+			template<typename T>
+			inline constexpr bool is_segmented_bulk_container_v = [] {
+				if constexpr( concepts::is_segmented_container_v<T> ) {
+					using element_t = typename T::value_type;
+					if constexpr( concepts::container_detect::is_fundamental_type_v<element_t> ) {
+						return true;
+					} else if constexpr( std::is_trivially_copyable_v<element_t> ) {
+						return is_class_of_fundamental_types_without_padding_v<element_t>;
+					} else {
+						return false;
+					}
+				} else {
+					return false;
+				}
+			}( );
+
+			/// Strings of byte sized characters, which dictionary encoding replaces with codes
+			template<typename T>
+			inline constexpr bool is_dictionary_string_v = [] {
+				if constexpr( is_contiguous_array_of_fundamental_like_types_v<T> ) {
+					using value_t = typename concepts::container_detect::container_value_type<T>::type;
+					return concepts::container_detect::is_character_type_v<value_t> and
+					       sizeof( value_t ) == 1;
+				} else {
+					return false;
+				}
+			}( );
+
+			/// Specialized by daw_burp_dictionary.h.  A dictionary visitor has a string( sv ) member
+			/// that is called for each dictionary string instead of emitting it, and a
+			/// measuring( counter ) member returning a visitor that adds what it would emit to counter
+			template<typename>
+			inline constexpr bool is_dictionary_visitor_v = false;
+
+			/// Specialized by daw_burp_dictionary.h.  A dictionary input has a read_string( ) member
+			/// returning the next dictionary string as a string_view
+			template<typename>
+			inline constexpr bool is_dictionary_input_v = false;
+
+			/// Call func with each element of a node based container, prefetching ahead of the
+			/// traversal as configured by concepts::node_traversal_traits
+			template<typename T, typename Function>
+			void for_each_node( T const &value, Function &&func ) {
+				using traits_t = concepts::node_traversal_traits<T>;
+				auto first = std::begin( value );
+				auto const last = std::end( value );
+				if constexpr( traits_t::batch_size > 0 ) {
+					using element_t = std::remove_reference_t<decltype( *first )>;
+					element_t *batch[traits_t::batch_size];
+					while( first != last ) {
+						std::size_t count = 0;
+						for( ; count < traits_t::batch_size and first != last; ++count, ++first ) {
+							batch[count] = std::addressof( *first );
+							prefetch_object( batch[count] );
+						}
+						for( std::size_t n = 0; n < count; ++n ) {
+							func( *batch[n] );
+						}
+					}
+				} else if constexpr( traits_t::prefetch_distance > 0 ) {
+					auto ahead = first;
+					for( std::size_t n = 0; n < traits_t::prefetch_distance and ahead != last; ++n ) {
+						prefetch_object( std::addressof( *ahead ) );
+						++ahead;
+					}
+					for( ; first != last; ++first ) {
+						if( ahead != last ) {
+							prefetch_object( std::addressof( *ahead ) );
+							++ahead;
+						}
+						func( *first );
+					}
+				} else {
+					for( ; first != last; ++first ) {
+						func( *first );
+					}
+				}
+			}
+
+			/// Counts the bytes passed on to Visitor, so that aligned_container's can pad relative to
+			/// the start of the encoding
+			template<typename Visitor>
+			struct offset_visitor {
+				Visitor *visitor;
+				std::size_t offset;
+
+				template<typename... ContiguousBytes>
+				void operator( )( ContiguousBytes const &...blobs ) {
+					offset += ( std::size( blobs ) + ... );
+					( *visitor )( blobs... );
+				}
+			};
+
+			template<typename>
+			inline constexpr bool is_offset_visitor_v = false;
+
+			template<typename Visitor>
+			inline constexpr bool is_offset_visitor_v<offset_visitor<Visitor>> = true;
+
+			/// Discards what it is given, an offset_visitor over it only measures
+			struct measure_sink {
+				template<typename... ContiguousBytes>
+				constexpr void operator( )( ContiguousBytes const &... ) const noexcept {}
+			};
+
+			using measuring_visitor = offset_visitor<measure_sink>;
+
+			/// Bytes visited so far.  Dictionary visitors do not count them and always report 0
+			template<typename Visitor>
+			std::size_t visitor_offset( Visitor const &visitor ) noexcept {
+				if constexpr( is_offset_visitor_v<Visitor> ) {
+					return visitor.offset;
+				} else {
+					return 0;
+				}
+			}
+
+			/// Zeros for the padding of aligned_container's
+			inline constexpr char alignment_padding[128]{ };
+
+			template<typename Visitor, typename T>
+			void visit_elements( Visitor &visitor, T const &value ) {
+				if constexpr( concepts::is_node_container_v<T> ) {
+					for_each_node( value, [&]( auto const &element ) { visit_impl1( visitor, element ); } );
+				} else {
+					for( auto const &element : value ) {
+						visit_impl1( visitor, element );
+					}
+				}
+			}
+
+			/// The width of the offsets, the end offset of each element relative to the first one and
+			/// then the elements.  Padding in the elements depends on where they start, which depends
+			/// on the width of the table, so they are measured at the offset they are written at and
+			/// again only in the rare case that the 4 byte offsets overflow.  When only measuring, the
+			/// table is skipped over and the elements are measured in place
+			template<typename Visitor, typename T>
+			void visit_indexed_elements( Visitor &visitor, T const &value ) {
+				auto const count = std::size( value );
+				if constexpr( std::is_same_v<Visitor, measuring_visitor> ) {
+					auto const start = visitor.offset + sizeof( std::uint8_t );
+					visitor.offset = start + count * sizeof( std::uint32_t );
+					auto const first = visitor.offset;
+					visit_elements( visitor, value );
+					if( visitor.offset - first > std::numeric_limits<std::uint32_t>::max( ) ) {
+						visitor.offset = start + count * sizeof( std::uint64_t );
+						visit_elements( visitor, value );
+					}
+				} else {
+					auto ends = std::vector<std::uint64_t>( );
+					ends.reserve( count );
+					auto const measure = [&]( std::size_t width ) {
+						ends.clear( );
+						auto sink = measure_sink{ };
+						auto const first = visitor_offset( visitor ) + sizeof( std::uint8_t ) + count * width;
+						auto counter = measuring_visitor{ &sink, first };
+						auto const measure_elements = [&]( auto &&element_visitor ) {
+							for( auto const &element : value ) {
+								visit_impl1( element_visitor, element );
+								ends.push_back( counter.offset - first );
+							}
+						};
+						if constexpr( is_dictionary_visitor_v<daw::remove_cvref_t<Visitor>> ) {
+							// Dictionary strings are written as their codes
+							measure_elements( visitor.measuring( counter ) );
+						} else {
+							measure_elements( counter );
+						}
+						return ends.empty( ) ? std::uint64_t{ 0 } : ends.back( );
+					};
+					// Once measured at width 8 the ends are only valid for a width 8 table, even when
+					// they would fit in 4 bytes
+					bool const is_narrow =
+					  measure( sizeof( std::uint32_t ) ) <= std::numeric_limits<std::uint32_t>::max( );
+					if( is_narrow ) {
+						std::uint8_t const width = sizeof( std::uint32_t );
+						auto const narrow = std::vector<std::uint32_t>( std::begin( ends ), std::end( ends ) );
+						visitor( daw::span( reinterpret_cast<char const *>( &width ), sizeof( width ) ) );
+						visitor( daw::span( reinterpret_cast<char const *>( std::data( narrow ) ),
+						                    std::size( narrow ) * sizeof( std::uint32_t ) ) );
+					} else {
+						(void)measure( sizeof( std::uint64_t ) );
+						std::uint8_t const width = sizeof( std::uint64_t );
+						visitor( daw::span( reinterpret_cast<char const *>( &width ), sizeof( width ) ) );
+						visitor( daw::span( reinterpret_cast<char const *>( std::data( ends ) ),
+						                    std::size( ends ) * sizeof( std::uint64_t ) ) );
+					}
+					visit_elements( visitor, value );
+				}
+			}
+
+			/// The offset width, end offsets and characters are assembled in one buffer so that the
+			/// output sees a single large write instead of two per string
+			template<typename Visitor, typename T>
+			void visit_string_table( Visitor &visitor, T const &value ) {
+				using element_t = daw::remove_cvref_t<decltype( *std::begin( value ) )>;
+				static_assert( is_contiguous_array_of_fundamental_like_types_v<element_t> and
+				                 concepts::container_detect::has_byte_sized_value_type_v<element_t>,
+				               "string_table elements must be strings of byte sized characters" );
+				std::uint64_t total = 0;
+				for( auto const &str : value ) {
+					total += std::size( str );
+				}
+				auto const width = string_table_width( total );
+				auto const count = std::size( value );
+				auto table = std::vector<char>( sizeof( width ) + count * width +
+				                                static_cast<std::size_t>( total ) );
+				table[0] = static_cast<char>( width );
+				auto *offsets = table.data( ) + sizeof( width );
+				auto *chars = offsets + count * width;
+				std::uint64_t end = 0;
+				for( auto const &str : value ) {
+					auto const sz = std::size( str );
+					if( sz > 0 ) {
+						std::memcpy( chars + end, std::data( str ), sz );
+					}
+					end += sz;
+					store_table_entry( offsets, end, width );
+					offsets += width;
+				}
+				visitor( daw::span( reinterpret_cast<char const *>( &count ), sizeof( count ) ) );
+				visitor( daw::span<char const>( table.data( ), table.size( ) ) );
+			}
+
+			/// Bits are packed 8 to a byte, least significant bit first
+			template<typename Visitor, typename Allocator>
+			void visit_bits( Visitor &visitor, std::vector<bool, Allocator> const &bits ) {
+				auto const bit_count = std::size( bits );
+				auto bytes = std::vector<unsigned char>( packed_bits_size( bit_count ) );
+				std::size_t n = 0;
+				for( bool const bit : bits ) {
+					bytes[n / 8U] |= static_cast<unsigned char>( static_cast<unsigned>( bit ) << ( n % 8U ) );
+					++n;
+				}
+				visitor( daw::span( reinterpret_cast<char const *>( &bit_count ), sizeof( bit_count ) ) );
+				visitor( daw::span( reinterpret_cast<char const *>( bytes.data( ) ), bytes.size( ) ) );
+			}
+
+			/// Bitsets that fit in a word are converted a word at a time
+			template<typename Visitor, std::size_t N>
+			void visit_bits( Visitor &visitor, std::bitset<N> const &bits ) {
+				unsigned char bytes[packed_bits_size( N )]{ };
+				if constexpr( N <= 64U ) {
+					auto word = static_cast<std::uint64_t>( bits.to_ullong( ) );
+					for( auto &b : bytes ) {
+						b = static_cast<unsigned char>( word & 0xFFU );
+						word >>= 8U;
+					}
+				} else {
+					for( std::size_t n = 0; n < N; ++n ) {
+						bytes[n / 8U] |=
+						  static_cast<unsigned char>( static_cast<unsigned>( bits.test( n ) ) << ( n % 8U ) );
+					}
+				}
+				visitor( daw::span( reinterpret_cast<char const *>( bytes ), sizeof( bytes ) ) );
+			}
+
 			template<typename Visitor, typename T>
 			void visit_impl1( Visitor &&visitor, T const &value ) {
-				if constexpr( burp_impl::has_generic_dto_v<T> ) {
+				using visitor_t = daw::remove_cvref_t<Visitor>;
+				if constexpr( not is_offset_visitor_v<visitor_t> and
+				              not is_dictionary_visitor_v<visitor_t> ) {
+					auto counted = offset_visitor<std::remove_reference_t<Visitor>>{ &visitor, 0 };
+					visit_impl1( counted, value );
+				} else if constexpr( burp_impl::has_generic_dto_v<T> ) {
 					using dto = generic_dto<T>;
 					burp_impl::visit_impl2( visitor,
 					                        value,
 					                        std::make_index_sequence<dto::member_count( )>{ } );
+				} else if constexpr( is_string_table_v<T> ) {
+					visit_string_table( visitor, value );
+				} else if constexpr( is_bool_vector_v<T> or is_bitset_v<T> ) {
+					visit_bits( visitor, value );
+				} else if constexpr( is_dictionary_visitor_v<daw::remove_cvref_t<Visitor>> and
+				                     is_dictionary_string_v<T> ) {
+					visitor.string( std::string_view( reinterpret_cast<char const *>( std::data( value ) ),
+					                                  std::size( value ) ) );
 				} else if constexpr( burp_impl::is_contiguous_array_of_fundamental_like_types_v<T> ) {
 					// String like types
 					auto const sz = concepts::container_size( value );
@@ -166,14 +665,55 @@ namespace daw::burp {
 					auto const count = std::size( value );
 					visitor( daw::span( reinterpret_cast<char const *>( std::data( value ) ),
 					                    count * concepts::container_detect::container_value_type<T>::size ) );
-				} else if constexpr( concepts::is_container_v<T> ) {
+				} else if constexpr( is_aligned_container_v<T> ) {
+					static_assert(
+					  is_contiguous_array_of_fundamental_like_types_v<typename T::container_type>,
+					  "aligned_container requires a contiguous container of fundamental types" );
 					auto const sz = concepts::container_size( value );
 					visitor( daw::span( reinterpret_cast<char const *>( &sz ), sizeof( sz ) ) );
-					auto result = sizeof( sz );
-					using value_type = typename T::value_type;
-					for( auto const &element : value ) {
-						result += visit_impl1( visitor, element );
+					auto const unpadded = visitor_offset( visitor ) + sizeof( std::uint8_t );
+					auto const pad =
+					  static_cast<std::uint8_t>( ( T::alignment - unpadded % T::alignment ) % T::alignment );
+					visitor( daw::span( reinterpret_cast<char const *>( &pad ), sizeof( pad ) ) );
+					if( pad > 0 ) {
+						visitor( daw::span( alignment_padding, pad ) );
+					}
+					visitor( daw::span( reinterpret_cast<char const *>( std::data( value ) ),
+					                    std::size( value ) *
+					                      concepts::container_detect::container_value_type<T>::size ) );
+				} else if constexpr( is_segmented_bulk_container_v<T> ) {
+					// Same encoding as the element loop below, one blob per segment
+					auto const sz = concepts::container_size( value );
+					visitor( daw::span( reinterpret_cast<char const *>( &sz ), sizeof( sz ) ) );
+					concepts::segmented_container_traits<T>::for_each_segment(
+					  value,
+					  [&]( auto const *segment, std::size_t count ) {
+						  visitor( daw::span( reinterpret_cast<char const *>( segment ),
+						                      count * sizeof( *segment ) ) );
+					  } );
+				} else if constexpr( concepts::is_writable_range_v<T> ) {
+					auto const sz = concepts::container_size( value );
+					visitor( daw::span( reinterpret_cast<char const *>( &sz ), sizeof( sz ) ) );
+					if constexpr( is_indexed_container_v<T> ) {
+						visit_indexed_elements( visitor, value );
+					} else {
+						visit_elements( visitor, value );
 					}
+				} else if constexpr( concepts::is_nullable_value_v<T> ) {
+					// A bool flag followed by the value when it is engaged
+					bool const has_value = concepts::nullable_value_has_value( value );
+					visitor( daw::span( reinterpret_cast<char const *>( &has_value ), sizeof( bool ) ) );
+					if( has_value ) {
+						visit_impl1( visitor, concepts::nullable_value_read( value ) );
+					}
+				} else if constexpr( is_narrowed_enum_v<T> ) {
+					using encoding_t = concepts::enum_encoding_t<T>;
+					using underlying_t = std::underlying_type_t<T>;
+					auto const encoded = static_cast<encoding_t>( value );
+					daw_burp_ensure( static_cast<underlying_t>( encoded ) ==
+					                   static_cast<underlying_t>( value ),
+					                 daw::burp::ErrorReason::OutputError );
+					visitor( daw::span( reinterpret_cast<char const *>( &encoded ), sizeof( encoded ) ) );
 				} else {
 					static_assert( concepts::container_detect::is_fundamental_type_v<T>,
 					               "Could not find mapping for type and it isn't a fundamental type" );
@@ -184,24 +724,698 @@ namespace daw::burp {
 
 		template<typename T>
 		std::size_t calc_size( T const &value ) {
-			std::size_t result = 0;
-			burp_impl::visit_impl1(
-			  [&]( auto const &...blobs ) { result += ( std::size( blobs ) + ... ); },
-			  value );
-			return result;
+			auto sink = burp_impl::measure_sink{ };
+			auto counter = burp_impl::measuring_visitor{ &sink, 0 };
+			burp_impl::visit_impl1( counter, value );
+			return counter.offset;
 		}
 
+		/// @brief Serialize value to writable.  When writable is an lvalue it is advanced/appended
+		/// to, e.g. a span will refer to the remaining buffer after the call
 		template<typename Writable, typename T>
-		std::size_t write( Writable writable, T const &value ) {
-			static_assert( concepts::is_writable_output_type_v<Writable> );
-			using out_t = concepts::writable_output_trait<Writable>;
+		std::size_t write( Writable &&writable, T const &value ) {
+			static_assert( concepts::is_writable_output_type_v<daw::remove_cvref_t<Writable>> );
+			using out_t = concepts::writable_output_trait<daw::remove_cvref_t<Writable>>;
 			auto const size_needed = calc_size( value );
 			daw_burp_ensure( size_needed <= out_t::capacity( writable ),
 			                 daw::burp::ErrorReason::OutputError );
+			if constexpr( concepts::has_writable_output_reserve_v<daw::remove_cvref_t<Writable>> ) {
+				out_t::reserve( writable, size_needed );
+			}
 			burp_impl::visit_impl1( [&]( auto const &...blobs ) { out_t::write( writable, blobs... ); },
 			                        value );
 			return size_needed;
 		}
 
+		namespace burp_impl {
+			/// Used when read is not given an allocator, nothing is uses-allocator constructible from
+			/// it so all values are default constructed
+			struct default_allocator_t {};
+
+			template<typename T, typename Allocator>
+			T construct_using_allocator( Allocator const &alloc ) {
+				if constexpr( std::uses_allocator_v<T, Allocator> ) {
+					if constexpr( std::is_constructible_v<T, std::allocator_arg_t, Allocator const &> ) {
+						return T( std::allocator_arg, alloc );
+					} else {
+						return T( alloc );
+					}
+				} else {
+					(void)alloc;
+					return T{ };
+				}
+			}
+
+			/// Associative containers have a value_type with a const key, read a non-const one so that
+			/// the key can be moved into the container
+			template<typename T>
+			struct read_value_type {
+				using type = T;
+			};
+
+			template<typename Key, typename Value>
+			struct read_value_type<std::pair<Key const, Value>> {
+				using type = std::pair<Key, Value>;
+			};
+
+			template<typename T>
+			using read_value_type_t = typename read_value_type<T>::type;
+
+			template<typename Readable>
+			std::size_t read_size( Readable &in ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				std::size_t result = 0;
+				in_t::read( in, reinterpret_cast<char *>( &result ), sizeof( result ) );
+				return result;
+			}
+
+			template<typename Readable>
+			void skip_bytes( Readable &in, std::size_t count ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				if constexpr( concepts::has_readable_input_skip_v<Readable> ) {
+					in_t::skip( in, count );
+				} else {
+					char discard[256];
+					while( count > 0 ) {
+						auto const chunk = count < sizeof( discard ) ? count : sizeof( discard );
+						in_t::read( in, discard, chunk );
+						count -= chunk;
+					}
+				}
+			}
+
+			/// Skip the padding before the elements of an aligned_container
+			template<typename Readable>
+			void skip_alignment_padding( Readable &in, std::size_t alignment ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				std::uint8_t pad = 0;
+				in_t::read( in, reinterpret_cast<char *>( &pad ), sizeof( pad ) );
+				daw_burp_ensure( pad < alignment, daw::burp::ErrorReason::InputError );
+				skip_bytes( in, pad );
+			}
+
+			/// Returns the width of the offsets in the table of an indexed_container
+			template<typename Readable>
+			std::size_t read_index_width( Readable &in ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				std::uint8_t width = 0;
+				in_t::read( in, reinterpret_cast<char *>( &width ), sizeof( width ) );
+				daw_burp_ensure( width == sizeof( std::uint32_t ) or width == sizeof( std::uint64_t ),
+				                 daw::burp::ErrorReason::InputError );
+				return width;
+			}
+
+			template<typename Readable>
+			std::uint64_t read_index_entry( Readable &in, std::size_t width ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				if( width == sizeof( std::uint32_t ) ) {
+					std::uint32_t result = 0;
+					in_t::read( in, reinterpret_cast<char *>( &result ), sizeof( result ) );
+					return result;
+				}
+				std::uint64_t result = 0;
+				in_t::read( in, reinterpret_cast<char *>( &result ), sizeof( result ) );
+				return result;
+			}
+
+			template<typename T>
+			constexpr std::size_t fixed_encoded_size_impl( );
+
+			template<typename T>
+			inline constexpr std::size_t fixed_encoded_size_v = fixed_encoded_size_impl<T>( );
+
+			/// Containers whose size cannot be checked against the input are grown as their elements
+			/// are read, this many bytes of elements at a time, so that a corrupt size fails at the end
+			/// of the input instead of allocating what it claims
+			inline constexpr std::size_t max_unchecked_reserve_bytes = 1024ULL * 1024ULL;
+
+			/// The fewest bytes that encode a T.  Anything without a fixed size has a size prefix or
+			/// flag
+			template<typename T>
+			inline constexpr std::size_t min_encoded_size_v =
+			  fixed_encoded_size_v<T> == dynamic_encoded_size ? 1 : fixed_encoded_size_v<T>;
+
+			/// Check count elements, each encoded in at least min_size bytes, against what remains of
+			/// an input that knows its size.  Returns how many elements of value_size bytes to allocate
+			/// before reading them, all of them when the count could be checked
+			template<typename Readable>
+			std::size_t checked_count( Readable const &in,
+			                           std::size_t count,
+			                           std::size_t min_size,
+			                           std::size_t value_size ) {
+				if constexpr( concepts::has_readable_input_size_v<Readable> ) {
+					if( min_size > 0 ) {
+						daw_burp_ensure( count <= concepts::readable_input_trait<Readable>::size( in ) /
+						                            min_size,
+						                 daw::burp::ErrorReason::InputError );
+						return count;
+					}
+				}
+				auto const limit = value_size < max_unchecked_reserve_bytes
+				                     ? max_unchecked_reserve_bytes / value_size
+				                     : std::size_t{ 1 };
+				return count < limit ? count : limit;
+			}
+
+			/// checked_count for elements of type T
+			template<typename T, typename Readable>
+			std::size_t checked_element_count( Readable const &in, std::size_t count ) {
+				return checked_count( in, count, min_encoded_size_v<T>, sizeof( T ) );
+			}
+
+			/// Resize a container of fundamental like types to count elements and read them.  When the
+			/// count cannot be checked they are read in bounded chunks
+			template<typename T, typename Readable>
+			void read_fundamental_elements( Readable &in, T &result, std::size_t count ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				constexpr auto value_size = concepts::container_detect::container_value_type<T>::size;
+				auto const chunk = checked_count( in, count, value_size, value_size );
+				std::size_t done = 0;
+				do {
+					auto const next = count - done <= chunk ? count : done + chunk;
+					result.resize( next );
+					in_t::read( in,
+					            reinterpret_cast<char *>( std::data( result ) ) + done * value_size,
+					            ( next - done ) * value_size );
+					done = next;
+				} while( done < count );
+			}
+
+			/// Returns the width of the offsets in the table of a string_table
+			template<typename Readable>
+			std::size_t read_string_table_width( Readable &in ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				std::uint8_t width = 0;
+				in_t::read( in, reinterpret_cast<char *>( &width ), sizeof( width ) );
+				daw_burp_ensure( width == sizeof( std::uint8_t ) or width == sizeof( std::uint16_t ) or
+				                   width == sizeof( std::uint32_t ) or width == sizeof( std::uint64_t ),
+				                 daw::burp::ErrorReason::InputError );
+				return width;
+			}
+
+			template<typename T, typename Readable, typename Allocator>
+			T read_string_table( Readable &in, Allocator const &alloc ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				using element_t = read_value_type_t<typename T::value_type>;
+				auto const sz = read_size( in );
+				auto const width = read_string_table_width( in );
+				daw_burp_ensure( sz <= dynamic_encoded_size / width, daw::burp::ErrorReason::InputError );
+				auto offsets_buffer = std::vector<char>( );
+				auto chars_buffer = std::vector<char>( );
+				// Contiguous inputs are referenced in place, others are read into the buffers
+				auto const take = [&]( std::vector<char> &buffer, std::size_t count ) -> char const * {
+					if constexpr( concepts::is_contiguous_readable_input_v<Readable> ) {
+						(void)buffer;
+						daw_burp_ensure( count <= in_t::size( in ), daw::burp::ErrorReason::InputError );
+						auto const *result = in_t::data( in );
+						skip_bytes( in, count );
+						return result;
+					} else {
+						read_fundamental_elements( in, buffer, count );
+						return buffer.data( );
+					}
+				};
+				auto const *offsets = take( offsets_buffer, sz * width );
+				auto const total = sz == 0 ? std::uint64_t{ 0 }
+				                           : load_table_entry( offsets + ( sz - 1U ) * width, width );
+				daw_burp_ensure( total <= dynamic_encoded_size, daw::burp::ErrorReason::InputError );
+				auto const *chars = take( chars_buffer, static_cast<std::size_t>( total ) );
+				auto result = construct_using_allocator<T>( alloc );
+				if constexpr( concepts::container_detect::is_reservable_container_v<T> ) {
+					// sz is trusted once its offsets have been read
+					result.reserve( sz );
+				}
+				std::uint64_t first = 0;
+				for( std::size_t n = 0; n < sz; ++n ) {
+					auto const last = load_table_entry( offsets + n * width, width );
+					daw_burp_ensure( first <= last and last <= total, daw::burp::ErrorReason::InputError );
+					auto element = construct_using_allocator<element_t>( alloc );
+					element.assign( chars + first, chars + last );
+					result.insert( std::end( result ), std::move( element ) );
+					first = last;
+				}
+				return result;
+			}
+
+			template<typename T, typename Readable, typename Allocator>
+			T read_bits( Readable &in, Allocator const &alloc ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				if constexpr( is_bitset_v<T> ) {
+					constexpr auto bit_count = bitset_size_v<T>;
+					unsigned char bytes[packed_bits_size( bit_count )]{ };
+					in_t::read( in, reinterpret_cast<char *>( bytes ), sizeof( bytes ) );
+					if constexpr( bit_count <= 64U ) {
+						unsigned long long word = 0;
+						for( std::size_t n = sizeof( bytes ); n > 0; --n ) {
+							word = ( word << 8U ) | bytes[n - 1U];
+						}
+						return T( word );
+					} else {
+						auto result = T( );
+						for( std::size_t n = 0; n < bit_count; ++n ) {
+							result.set( n, ( ( bytes[n / 8U] >> ( n % 8U ) ) & 1U ) != 0 );
+						}
+						return result;
+					}
+				} else {
+					auto const bit_count = read_size( in );
+					auto const byte_count = packed_bits_size( bit_count );
+					auto bytes = std::vector<unsigned char>( );
+					read_fundamental_elements( in, bytes, byte_count );
+					auto result = construct_using_allocator<T>( alloc );
+					result.resize( bit_count );
+					std::size_t n = 0;
+					for( auto &&bit : result ) {
+						bit = ( ( bytes[n / 8U] >> ( n % 8U ) ) & 1U ) != 0;
+						++n;
+					}
+					return result;
+				}
+			}
+
+			/// Resize a segmented container and read its elements a segment at a time
+			template<typename T, typename Readable>
+			void read_segments( Readable &in, T &result, std::size_t sz ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				using value_t = typename T::value_type;
+				constexpr auto value_size = sizeof( value_t );
+				auto const chunk = checked_count( in, sz, value_size, value_size );
+				if( chunk == sz ) {
+					result.resize( sz );
+					concepts::segmented_container_traits<T>::for_each_segment(
+					  result,
+					  [&]( auto *segment, std::size_t count ) {
+						  in_t::read( in, reinterpret_cast<char *>( segment ), count * value_size );
+					  } );
+					return;
+				}
+				// Unchecked sizes are read a chunk at a time and appended
+				result.clear( );
+				auto buffer = std::vector<value_t>( chunk );
+				while( sz > 0 ) {
+					auto const count = sz < chunk ? sz : chunk;
+					in_t::read( in, reinterpret_cast<char *>( buffer.data( ) ), count * value_size );
+					result.insert( std::end( result ), buffer.data( ), buffer.data( ) + count );
+					sz -= count;
+				}
+			}
+
+			template<typename T, typename Readable, typename Allocator>
+			T read_impl1( Readable &in, Allocator const &alloc );
+
+			template<typename T, std::size_t I>
+			using dto_member_t = daw::remove_cvref_t<
+			  std::tuple_element_t<I, DAW_TYPEOF( generic_dto<T>::to_tuple( std::declval<T &>( ) ) )>>;
+
+			template<typename T, typename Readable, typename Allocator, std::size_t... Is>
+			T read_impl2( Readable &in, Allocator const &alloc, std::index_sequence<Is...> ) {
+				if constexpr( concepts::nullable_impl::is_list_constructible_v<T,
+				                                                               dto_member_t<T, Is>...> ) {
+					// Braced init is evaluated in order and each member is constructed in place
+					return T{ read_impl1<dto_member_t<T, Is>>( in, alloc )... };
+				} else {
+					auto result = construct_using_allocator<T>( alloc );
+					auto tp = generic_dto<T>::to_tuple( result );
+					auto const do_read = [&]( auto &member ) {
+						member = read_impl1<DAW_TYPEOF( member )>( in, alloc );
+						return true;
+					};
+					bool expander[]{ do_read( std::get<Is>( tp ) )... };
+					(void)expander;
+					return result;
+				}
+			}
+
+			template<typename T, typename Readable, typename Allocator>
+			T read_impl1( Readable &in, Allocator const &alloc ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				if constexpr( burp_impl::has_generic_dto_v<T> ) {
+					if constexpr( is_class_of_fundamental_types_without_padding_v<T> and
+					              std::is_trivially_copyable_v<T> and
+					              std::is_default_constructible_v<T> ) {
+						auto result = T{ };
+						in_t::read( in, reinterpret_cast<char *>( &result ), sizeof( T ) );
+						return result;
+					} else {
+						using dto = generic_dto<T>;
+						return burp_impl::read_impl2<T>( in,
+						                                 alloc,
+						                                 std::make_index_sequence<dto::member_count( )>{ } );
+					}
+				} else if constexpr( is_string_table_v<T> ) {
+					return read_string_table<T>( in, alloc );
+				} else if constexpr( is_bool_vector_v<T> or is_bitset_v<T> ) {
+					return read_bits<T>( in, alloc );
+				} else if constexpr( is_dictionary_input_v<Readable> and is_dictionary_string_v<T> ) {
+					auto const str = in.read_string( );
+					auto result = construct_using_allocator<T>( alloc );
+					if constexpr( concepts::container_detect::is_resizable_container_v<T> ) {
+						result.resize( str.size( ) );
+					} else {
+						daw_burp_ensure( std::size( result ) == str.size( ),
+						                 daw::burp::ErrorReason::InputError );
+					}
+					if( not str.empty( ) ) {
+						std::memcpy( std::data( result ), str.data( ), str.size( ) );
+					}
+					return result;
+				} else if constexpr( burp_impl::is_contiguous_array_of_fundamental_like_types_v<T> or
+				                     is_aligned_container_v<T> ) {
+					// String like types
+					constexpr auto value_size = concepts::container_detect::container_value_type<T>::size;
+					auto const sz = read_size( in );
+					if constexpr( is_aligned_container_v<T> ) {
+						skip_alignment_padding( in, T::alignment );
+					}
+					auto result = construct_using_allocator<T>( alloc );
+					if constexpr( concepts::container_detect::is_resizable_container_v<T> ) {
+						read_fundamental_elements( in, result, sz );
+					} else {
+						daw_burp_ensure( std::size( result ) == sz, daw::burp::ErrorReason::InputError );
+						in_t::read( in, reinterpret_cast<char *>( std::data( result ) ), sz * value_size );
+					}
+					return result;
+				} else if constexpr( concepts::is_container_v<T> ) {
+					auto const sz = read_size( in );
+					if constexpr( is_indexed_container_v<T> ) {
+						// The offsets are only needed for random access
+						auto const width = read_index_width( in );
+						daw_burp_ensure( sz <= dynamic_encoded_size / width,
+						                 daw::burp::ErrorReason::InputError );
+						skip_bytes( in, sz * width );
+					}
+					auto result = construct_using_allocator<T>( alloc );
+					if constexpr( is_segmented_bulk_container_v<T> and
+					              concepts::container_detect::is_resizable_container_v<T> ) {
+						read_segments( in, result, sz );
+					} else if constexpr( concepts::container_detect::is_detected_container_v<T> ) {
+						using value_type = read_value_type_t<typename T::value_type>;
+						auto const reserve = checked_element_count<value_type>( in, sz );
+						if constexpr( concepts::container_detect::is_reservable_container_v<T> ) {
+							result.reserve( reserve );
+						}
+						for( std::size_t n = 0; n < sz; ++n ) {
+							result.insert( std::end( result ), read_impl1<value_type>( in, alloc ) );
+						}
+					} else {
+						// Fixed sized containers
+						daw_burp_ensure( std::size( result ) == sz, daw::burp::ErrorReason::InputError );
+						for( auto &element : result ) {
+							element = read_impl1<DAW_TYPEOF( element )>( in, alloc );
+						}
+					}
+					return result;
+				} else if constexpr( concepts::is_nullable_value_v<T> ) {
+					using traits_t = concepts::nullable_value_traits<T>;
+					using value_type = concepts::nullable_value_type_t<T>;
+					bool has_value = false;
+					in_t::read( in, reinterpret_cast<char *>( &has_value ), sizeof( bool ) );
+					if( not has_value ) {
+						return traits_t{ }( concepts::construct_nullable_with_empty );
+					}
+					if constexpr( not std::is_same_v<Allocator, default_allocator_t> and
+					              std::is_invocable_v<traits_t,
+					                                  concepts::construct_nullable_with_allocator_t,
+					                                  Allocator const &,
+					                                  value_type> ) {
+						return traits_t{ }( concepts::construct_nullable_with_allocator,
+						                    alloc,
+						                    read_impl1<value_type>( in, alloc ) );
+					} else {
+						return traits_t{ }( concepts::construct_nullable_with_value,
+						                    read_impl1<value_type>( in, alloc ) );
+					}
+				} else if constexpr( is_narrowed_enum_v<T> ) {
+					auto encoded = concepts::enum_encoding_t<T>{ };
+					in_t::read( in, reinterpret_cast<char *>( &encoded ), sizeof( encoded ) );
+					return static_cast<T>( encoded );
+				} else {
+					static_assert( concepts::container_detect::is_fundamental_type_v<T>,
+					               "Could not find mapping for type and it isn't a fundamental type" );
+					auto result = T{ };
+					in_t::read( in, reinterpret_cast<char *>( &result ), sizeof( T ) );
+					return result;
+				}
+			}
+
+			template<typename T, std::size_t... Is>
+			constexpr std::size_t fixed_dto_encoded_size( std::index_sequence<Is...> ) {
+				if constexpr( ( ( fixed_encoded_size_v<dto_member_t<T, Is>> != dynamic_encoded_size ) and
+				                ... ) ) {
+					return ( std::size_t{ 0 } + ... + fixed_encoded_size_v<dto_member_t<T, Is>> );
+				} else {
+					return dynamic_encoded_size;
+				}
+			}
+
+			template<typename T>
+			constexpr std::size_t fixed_encoded_size_impl( ) {
+				if constexpr( has_generic_dto_v<T> ) {
+					if constexpr( is_class_of_fundamental_types_without_padding_v<T> ) {
+						return sizeof( T );
+					} else {
+						return fixed_dto_encoded_size<T>(
+						  std::make_index_sequence<generic_dto<T>::member_count( )>{ } );
+					}
+				} else if constexpr( is_bitset_v<T> ) {
+					return packed_bits_size( bitset_size_v<T> );
+				} else if constexpr( is_narrowed_enum_v<T> ) {
+					return sizeof( concepts::enum_encoding_t<T> );
+				} else if constexpr( is_contiguous_array_of_fundamental_like_types_v<T> or
+				                     concepts::is_container_v<T> or
+				                     concepts::is_nullable_value_v<T> ) {
+					return dynamic_encoded_size;
+				} else if constexpr( concepts::container_detect::is_fundamental_type_v<T> ) {
+					return sizeof( T );
+				} else {
+					return dynamic_encoded_size;
+				}
+			}
+
+			template<typename T>
+			using container_element_t =
+			  read_value_type_t<DAW_TYPEOF( *std::begin( std::declval<T &>( ) ) )>;
+
+			template<typename T, typename Readable>
+			void skip_impl1( Readable &in );
+
+			template<typename T, typename Readable, std::size_t... Is>
+			void skip_impl2( Readable &in, std::index_sequence<Is...> ) {
+				(void)in;
+				( skip_impl1<dto_member_t<T, Is>>( in ), ... );
+			}
+
+			/// Advance in past the encoding of a T without constructing it.  Requires the
+			/// Readable to support skip
+			template<typename T, typename Readable>
+			void skip_impl1( Readable &in ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				if constexpr( fixed_encoded_size_v<T> != dynamic_encoded_size ) {
+					skip_bytes( in, fixed_encoded_size_v<T> );
+				} else if constexpr( has_generic_dto_v<T> ) {
+					skip_impl2<T>( in, std::make_index_sequence<generic_dto<T>::member_count( )>{ } );
+				} else if constexpr( is_string_table_v<T> ) {
+					// The last offset is the number of characters
+					auto const sz = read_size( in );
+					auto const width = read_string_table_width( in );
+					if( sz == 0 ) {
+						return;
+					}
+					daw_burp_ensure( sz <= dynamic_encoded_size / width,
+					                 daw::burp::ErrorReason::InputError );
+					skip_bytes( in, ( sz - 1U ) * width );
+					char last[sizeof( std::uint64_t )];
+					in_t::read( in, last, width );
+					skip_bytes( in, static_cast<std::size_t>( load_table_entry( last, width ) ) );
+				} else if constexpr( is_bool_vector_v<T> ) {
+					skip_bytes( in, packed_bits_size( read_size( in ) ) );
+				} else if constexpr( is_dictionary_input_v<Readable> and is_dictionary_string_v<T> ) {
+					(void)in.read_string( );
+				} else if constexpr( is_contiguous_array_of_fundamental_like_types_v<T> or
+				                     is_aligned_container_v<T> ) {
+					constexpr auto value_size = concepts::container_detect::container_value_type<T>::size;
+					auto const sz = read_size( in );
+					if constexpr( is_aligned_container_v<T> ) {
+						skip_alignment_padding( in, T::alignment );
+					}
+					daw_burp_ensure( sz <= dynamic_encoded_size / value_size,
+					                 daw::burp::ErrorReason::InputError );
+					skip_bytes( in, sz * value_size );
+				} else if constexpr( concepts::is_container_v<T> ) {
+					using element_t = container_element_t<T>;
+					auto const sz = read_size( in );
+					if constexpr( is_indexed_container_v<T> ) {
+						// The last offset is the size of all the elements
+						auto const width = read_index_width( in );
+						if( sz == 0 ) {
+							return;
+						}
+						daw_burp_ensure( sz <= dynamic_encoded_size / width,
+						                 daw::burp::ErrorReason::InputError );
+						skip_bytes( in, ( sz - 1U ) * width );
+						skip_bytes( in, static_cast<std::size_t>( read_index_entry( in, width ) ) );
+					} else if constexpr( fixed_encoded_size_v<element_t> != dynamic_encoded_size ) {
+						daw_burp_ensure( sz <= dynamic_encoded_size / fixed_encoded_size_v<element_t>,
+						                 daw::burp::ErrorReason::InputError );
+						skip_bytes( in, sz * fixed_encoded_size_v<element_t> );
+					} else {
+						for( std::size_t n = 0; n < sz; ++n ) {
+							skip_impl1<element_t>( in );
+						}
+					}
+				} else {
+					static_assert( concepts::is_nullable_value_v<T>,
+					               "Could not find mapping for type and it isn't a fundamental type" );
+					bool has_value = false;
+					in_t::read( in, reinterpret_cast<char *>( &has_value ), sizeof( bool ) );
+					if( has_value ) {
+						skip_impl1<concepts::nullable_value_type_t<T>>( in );
+					}
+				}
+			}
+
+			template<typename T, std::size_t... Is>
+			constexpr bool has_mutable_dto_members( std::index_sequence<Is...> ) {
+				using tp_t = decltype( generic_dto<T>::to_tuple( std::declval<T &>( ) ) );
+				return ( ( std::is_lvalue_reference_v<std::tuple_element_t<Is, tp_t>> and
+				           not std::is_const_v<
+				             std::remove_reference_t<std::tuple_element_t<Is, tp_t>>> ) and
+				         ... );
+			}
+
+			template<typename T, typename Readable, typename Allocator>
+			void read_into_impl1( Readable &in, T &value, Allocator const &alloc );
+
+			template<typename T, typename Readable, typename Allocator, std::size_t... Is>
+			void read_into_impl2( Readable &in,
+			                      T &value,
+			                      Allocator const &alloc,
+			                      std::index_sequence<Is...> ) {
+				if constexpr( has_mutable_dto_members<T>( std::index_sequence<Is...>{ } ) ) {
+					auto tp = generic_dto<T>::to_tuple( value );
+					(void)tp;
+					( read_into_impl1( in, std::get<Is>( tp ), alloc ), ... );
+				} else {
+					value = read_impl1<T>( in, alloc );
+				}
+			}
+
+			/// Like read_impl1 but decodes into an existing value, reusing the capacity of the
+			/// strings/containers it already holds
+			template<typename T, typename Readable, typename Allocator>
+			void read_into_impl1( Readable &in, T &value, Allocator const &alloc ) {
+				using in_t = concepts::readable_input_trait<Readable>;
+				if constexpr( is_string_table_v<T> ) {
+					value = read_string_table<T>( in, alloc );
+				} else if constexpr( is_bool_vector_v<T> ) {
+					value = read_bits<T>( in, alloc );
+				} else if constexpr( has_generic_dto_v<T> ) {
+					if constexpr( is_class_of_fundamental_types_without_padding_v<T> and
+					              std::is_trivially_copyable_v<T> ) {
+						in_t::read( in, reinterpret_cast<char *>( &value ), sizeof( T ) );
+					} else {
+						read_into_impl2(
+						  in, value, alloc, std::make_index_sequence<generic_dto<T>::member_count( )>{ } );
+					}
+				} else if constexpr( is_dictionary_input_v<Readable> and is_dictionary_string_v<T> and
+				                     concepts::container_detect::is_resizable_container_v<T> ) {
+					auto const str = in.read_string( );
+					value.resize( str.size( ) );
+					if( not str.empty( ) ) {
+						std::memcpy( std::data( value ), str.data( ), str.size( ) );
+					}
+				} else if constexpr( ( is_contiguous_array_of_fundamental_like_types_v<T> or
+				                       is_aligned_container_v<T> ) and
+				                     concepts::container_detect::is_resizable_container_v<T> ) {
+					auto const sz = read_size( in );
+					if constexpr( is_aligned_container_v<T> ) {
+						skip_alignment_padding( in, T::alignment );
+					}
+					read_fundamental_elements( in, value, sz );
+				} else if constexpr( is_segmented_bulk_container_v<T> and
+				                     concepts::container_detect::is_resizable_container_v<T> ) {
+					read_segments( in, value, read_size( in ) );
+				} else if constexpr( concepts::container_detect::is_detected_container_v<T> ) {
+					using element_t = read_value_type_t<typename T::value_type>;
+					auto const sz = read_size( in );
+					if constexpr( is_indexed_container_v<T> ) {
+						auto const width = read_index_width( in );
+						daw_burp_ensure( sz <= dynamic_encoded_size / width,
+						                 daw::burp::ErrorReason::InputError );
+						skip_bytes( in, sz * width );
+					}
+					auto const reserve = checked_element_count<element_t>( in, sz );
+					if constexpr( concepts::container_detect::is_resizable_container_v<T> and
+					              std::is_same_v<element_t, typename T::value_type> and
+					              std::is_default_constructible_v<element_t> ) {
+						// Existing elements are reused, those past an unchecked reserve are appended
+						auto const existing = std::size( value ) < sz ? std::size( value ) : sz;
+						value.resize( existing < reserve ? reserve : existing );
+						for( auto &element : value ) {
+							read_into_impl1( in, element, alloc );
+						}
+						for( auto n = std::size( value ); n < sz; ++n ) {
+							value.insert( std::end( value ), read_impl1<element_t>( in, alloc ) );
+						}
+					} else {
+						value.clear( );
+						if constexpr( concepts::container_detect::is_reservable_container_v<T> ) {
+							value.reserve( reserve );
+						}
+						for( std::size_t n = 0; n < sz; ++n ) {
+							value.insert( std::end( value ), read_impl1<element_t>( in, alloc ) );
+						}
+					}
+				} else {
+					value = read_impl1<T>( in, alloc );
+				}
+			}
+		} // namespace burp_impl
+
+		/// @brief Deserialize a T from readable.  Every allocator aware value in the result(e.g.
+		/// std::pmr containers) is constructed with alloc.  When readable is a mutable lvalue it is
+		/// advanced past the consumed bytes
+		template<typename T,
+		         typename Readable,
+		         typename Allocator,
+		         std::enable_if_t<not std::is_pointer_v<Allocator>, std::nullptr_t> = nullptr>
+		T read( Readable &&readable, Allocator const &alloc ) {
+			using in_t = daw::remove_cvref_t<Readable>;
+			static_assert( concepts::is_readable_input_type_v<in_t> );
+			if constexpr( std::is_const_v<std::remove_reference_t<Readable>> ) {
+				auto in = in_t( readable );
+				return burp_impl::read_impl1<T>( in, alloc );
+			} else {
+				return burp_impl::read_impl1<T>( readable, alloc );
+			}
+		}
+
+		template<typename T, typename Readable>
+		T read( Readable &&readable ) {
+			return read<T>( DAW_FWD( readable ), burp_impl::default_allocator_t{ } );
+		}
+
+		/// @brief Deserialize into an existing value, reusing the memory held by its strings and
+		/// containers.  Decoding a stream of records into the same object avoids most allocations.
+		template<typename T, typename Readable>
+		void read_into( Readable &&readable, T &value ) {
+			using in_t = daw::remove_cvref_t<Readable>;
+			static_assert( concepts::is_readable_input_type_v<in_t> );
+			if constexpr( std::is_const_v<std::remove_reference_t<Readable>> ) {
+				auto in = in_t( readable );
+				burp_impl::read_into_impl1( in, value, burp_impl::default_allocator_t{ } );
+			} else {
+				burp_impl::read_into_impl1( readable, value, burp_impl::default_allocator_t{ } );
+			}
+		}
+
+#if defined( DAW_BURP_HAS_PMR )
+		/// @brief Deserialize a T with all of its allocations coming from resource.  Using a
+		/// std::pmr::monotonic_buffer_resource allows the whole tree to be released at once
+		template<typename T, typename Readable>
+		T read( Readable &&readable, std::pmr::memory_resource *resource ) {
+			return read<T>( DAW_FWD( readable ), std::pmr::polymorphic_allocator<std::byte>( resource ) );
+		}
+#endif
 	} // namespace DAW_BURP_VER
 } // namespace daw::burp
\ No newline at end of file
@@ -0,0 +1,312 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#if defined( DAW_HAS_UNISTD ) and __has_include( <sys/mman.h> )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define DAW_BURP_HAS_APPEND_LOG
+#endif
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			/// Each record is a header followed by the message, padded so that the next header is
+			/// aligned.  The header is one word holding the size in the low half and the state in the
+			/// high half.  A producer claims a record by setting its header from zero to the size and
+			/// the reserved state in one step, and sets the committed state once the message is
+			/// written.  A zero header marks the end of the log and a record that stays reserved, from
+			/// a producer that died, can still be skipped over
+			using append_log_record_header = std::atomic<std::uint64_t>;
+			static_assert( sizeof( append_log_record_header ) == 8 and
+			               append_log_record_header::is_always_lock_free );
+
+			inline constexpr std::uint32_t append_log_reserved = 0x5653'4552U;
+			inline constexpr std::uint32_t append_log_committed = 0x4255'5250U;
+
+			constexpr std::uint64_t append_log_header( std::uint32_t size,
+			                                           std::uint32_t state ) noexcept {
+				return ( static_cast<std::uint64_t>( state ) << 32U ) | size;
+			}
+
+			constexpr std::size_t append_log_stride( std::size_t size ) noexcept {
+				return sizeof( append_log_record_header ) + ( ( size + 7U ) & ~std::size_t{ 7U } );
+			}
+
+			/// Headers in a mapping are read atomically so that a committed message is visible with
+			/// its state.  Unaligned data, which cannot be a live mapping, is copied
+			inline std::uint64_t load_append_log_header( char const *ptr ) noexcept {
+				if( reinterpret_cast<std::uintptr_t>( ptr ) % alignof( append_log_record_header ) == 0 ) {
+					return reinterpret_cast<append_log_record_header const *>( ptr )->load(
+					  std::memory_order_acquire );
+				}
+				std::uint64_t result = 0;
+				std::memcpy( &result, ptr, sizeof( result ) );
+				return result;
+			}
+		} // namespace burp_impl
+
+		/// @brief Call func with the bytes of each committed record of an append_log, in log order.
+		/// Records that were reserved but never committed are skipped, on a log that is still being
+		/// appended to they may be in progress.  Returns the size of the part of data holding
+		/// records
+		template<typename Function>
+		std::size_t for_each_log_record( daw::span<char const> data, Function &&func ) {
+			std::size_t pos = 0;
+			while( data.size( ) - pos >= sizeof( burp_impl::append_log_record_header ) ) {
+				auto const header = burp_impl::load_append_log_header( data.data( ) + pos );
+				auto const size = static_cast<std::uint32_t>( header );
+				auto const state = static_cast<std::uint32_t>( header >> 32U );
+				auto const stride = burp_impl::append_log_stride( size );
+				if( ( state != burp_impl::append_log_committed and
+				      state != burp_impl::append_log_reserved ) or
+				    stride > data.size( ) - pos ) {
+					break;
+				}
+				if( state == burp_impl::append_log_committed ) {
+					func( daw::span<char const>(
+					  data.data( ) + pos + sizeof( burp_impl::append_log_record_header ),
+					  size ) );
+				}
+				pos += stride;
+			}
+			return pos;
+		}
+
+#if defined( DAW_BURP_HAS_APPEND_LOG )
+		struct append_log_options {
+			/// @brief Largest size the log can grow to, this much address space is reserved up front
+			std::size_t max_size = sizeof( void * ) >= 8 ? ( std::size_t{ 1 } << 36U )
+			                                             : ( std::size_t{ 1 } << 30U );
+			/// @brief The file is extended and mapped in steps of this size, a multiple of the page size
+			std::size_t grow_size = std::size_t{ 64 } << 20U;
+			/// @brief How often the background thread writes back new records and maps ahead
+			std::chrono::milliseconds flush_interval{ 100 };
+		};
+
+		/// @brief A log file that many threads append burp messages to without a lock.  A producer
+		/// claims the header at the shared tail with a compare and swap, advances the tail past its
+		/// record, serializes the value directly into the mapped file and then marks the record
+		/// committed.  A background thread extends the file ahead of the producers and writes back
+		/// what has been appended.  Read it back with for_each_log_record.  Opening an existing log
+		/// continues after its last record, skipping any that a crashed producer left uncommitted.
+		class append_log {
+			int m_fd = -1;
+			char *m_base = nullptr;
+			append_log_options m_options;
+			std::atomic<std::uint64_t> m_tail{ 0 };
+			std::atomic<std::uint64_t> m_mapped{ 0 };
+			std::uint64_t m_flushed = 0;
+			std::mutex m_grow_mutex{ };
+			std::mutex m_worker_mutex{ };
+			std::condition_variable m_worker_cv{ };
+			bool m_is_stopping = false;
+			std::thread m_worker{ };
+
+			/// Extend the file and its mapping to cover at least end
+			void grow( std::uint64_t end ) {
+				auto const lock = std::lock_guard<std::mutex>( m_grow_mutex );
+				auto const mapped = m_mapped.load( std::memory_order_relaxed );
+				if( end <= mapped ) {
+					return;
+				}
+				auto const step = static_cast<std::uint64_t>( m_options.grow_size );
+				auto const new_mapped = ( ( end + step - 1U ) / step ) * step;
+				daw_burp_ensure( new_mapped <= m_options.max_size and
+				                   ::ftruncate( m_fd, static_cast<off_t>( new_mapped ) ) == 0,
+				                 daw::burp::ErrorReason::OutputError );
+				void *const mapping = ::mmap( m_base + mapped,
+				                              static_cast<std::size_t>( new_mapped - mapped ),
+				                              PROT_READ | PROT_WRITE,
+				                              MAP_SHARED | MAP_FIXED,
+				                              m_fd,
+				                              static_cast<off_t>( mapped ) );
+				daw_burp_ensure( mapping != MAP_FAILED, daw::burp::ErrorReason::OutputError );
+				m_mapped.store( new_mapped, std::memory_order_release );
+			}
+
+			void ensure_mapped( std::uint64_t end ) {
+				if( end > m_mapped.load( std::memory_order_acquire ) ) {
+					grow( end );
+				}
+			}
+
+			void write_back( int flags ) {
+				auto const tail = std::min( m_tail.load( std::memory_order_acquire ),
+				                            m_mapped.load( std::memory_order_acquire ) );
+				auto const page = static_cast<std::uint64_t>( ::sysconf( _SC_PAGESIZE ) );
+				auto const first = ( m_flushed / page ) * page;
+				if( tail > first ) {
+					(void)::msync( m_base + first, static_cast<std::size_t>( tail - first ), flags );
+					m_flushed = tail;
+				}
+			}
+
+			void run_worker( ) {
+				auto lock = std::unique_lock<std::mutex>( m_worker_mutex );
+				while( not m_is_stopping ) {
+					m_worker_cv.wait_for( lock, m_options.flush_interval );
+					try {
+						// Keep half a step mapped ahead so that producers rarely extend the file themselves
+						ensure_mapped( m_tail.load( std::memory_order_relaxed ) + m_options.grow_size / 2U );
+					} catch( daw::burp::ErrorReason ) {
+						// The producer that reaches the end reports it
+					}
+					write_back( MS_ASYNC );
+				}
+			}
+
+		public:
+			/// @brief Open or create the log at path
+			explicit append_log( std::string const &path, append_log_options options = { } )
+			  : m_options( options ) {
+				auto const page = static_cast<std::size_t>( ::sysconf( _SC_PAGESIZE ) );
+				daw_burp_ensure( m_options.grow_size > 0 and m_options.grow_size % page == 0,
+				                 daw::burp::ErrorReason::OutputError );
+				m_fd = ::open( path.c_str( ), O_RDWR | O_CREAT | O_CLOEXEC, 0644 );
+				daw_burp_ensure( m_fd >= 0, daw::burp::ErrorReason::OutputError );
+				void *const reserved = ::mmap( nullptr,
+				                               m_options.max_size,
+				                               PROT_NONE,
+				                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+				                               -1,
+				                               0 );
+				if( reserved == MAP_FAILED ) {
+					::close( m_fd );
+				}
+				daw_burp_ensure( reserved != MAP_FAILED, daw::burp::ErrorReason::OutputError );
+				m_base = static_cast<char *>( reserved );
+				try {
+					recover( );
+				} catch( ... ) {
+					::munmap( m_base, m_options.max_size );
+					::close( m_fd );
+					throw;
+				}
+				m_worker = std::thread( [this] { run_worker( ); } );
+			}
+
+			append_log( append_log const & ) = delete;
+			append_log &operator=( append_log const & ) = delete;
+
+			/// @brief All producers must be finished before the log is destroyed
+			~append_log( ) {
+				{
+					auto const lock = std::lock_guard<std::mutex>( m_worker_mutex );
+					m_is_stopping = true;
+				}
+				m_worker_cv.notify_one( );
+				m_worker.join( );
+				write_back( MS_SYNC );
+				auto const tail = std::min( m_tail.load( ), m_mapped.load( ) );
+				::munmap( m_base, m_options.max_size );
+				// Drop the space mapped ahead of the last record
+				(void)::ftruncate( m_fd, static_cast<off_t>( tail ) );
+				::close( m_fd );
+			}
+
+			/// @brief Append value as one record and return its serialized size.  Safe to call from
+			/// any number of threads
+			template<typename T>
+			std::size_t append( T const &value ) {
+				auto const size = daw::burp::calc_size( value );
+				daw_burp_ensure( size <= std::numeric_limits<std::uint32_t>::max( ),
+				                 daw::burp::ErrorReason::OutputError );
+				auto const stride = burp_impl::append_log_stride( size );
+				auto const reserved =
+				  burp_impl::append_log_header( static_cast<std::uint32_t>( size ),
+				                                burp_impl::append_log_reserved );
+				auto offset = m_tail.load( std::memory_order_acquire );
+				burp_impl::append_log_record_header *header = nullptr;
+				while( true ) {
+					ensure_mapped( offset + sizeof( burp_impl::append_log_record_header ) );
+					header = reinterpret_cast<burp_impl::append_log_record_header *>( m_base + offset );
+					auto expected = std::uint64_t{ 0 };
+					if( header->compare_exchange_strong( expected, reserved, std::memory_order_acq_rel ) ) {
+						break;
+					}
+					// Another producer claimed it, help move the tail past its record and retry
+					auto const next =
+					  offset + burp_impl::append_log_stride( static_cast<std::uint32_t>( expected ) );
+					if( m_tail.compare_exchange_strong( offset, next, std::memory_order_acq_rel ) ) {
+						offset = next;
+					}
+				}
+				auto current = offset;
+				(void)m_tail.compare_exchange_strong( current, offset + stride, std::memory_order_acq_rel );
+				ensure_mapped( offset + stride );
+				char *out = m_base + offset + sizeof( burp_impl::append_log_record_header );
+				burp_impl::visit_impl1(
+				  [&]( auto const &...blobs ) {
+					  concepts::writable_output_trait<char *>::write( out, blobs... );
+				  },
+				  value );
+				header->store( burp_impl::append_log_header( static_cast<std::uint32_t>( size ),
+				                                             burp_impl::append_log_committed ),
+				               std::memory_order_release );
+				return size;
+			}
+
+			/// @brief Write back every record committed so far and wait for it to reach the file
+			void flush( ) {
+				auto const lock = std::lock_guard<std::mutex>( m_worker_mutex );
+				m_flushed = 0;
+				write_back( MS_SYNC );
+			}
+
+			/// @brief Bytes reserved by producers so far, including record headers and padding
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return static_cast<std::size_t>( m_tail.load( std::memory_order_relaxed ) );
+			}
+
+		private:
+			/// Continue after the records of an existing file.  Anything after the last header was
+			/// never claimed and is zeroed so that stale bytes cannot look like a record
+			void recover( ) {
+				struct ::stat st{ };
+				daw_burp_ensure( ::fstat( m_fd, &st ) == 0 and
+				                   static_cast<std::size_t>( st.st_size ) <= m_options.max_size,
+				                 daw::burp::ErrorReason::InputError );
+				auto const file_size = static_cast<std::uint64_t>( st.st_size );
+				if( file_size == 0 ) {
+					return;
+				}
+				grow( file_size );
+				auto const end = for_each_log_record(
+				  daw::span<char const>( m_base, static_cast<std::size_t>( file_size ) ),
+				  []( daw::span<char const> ) {} );
+				std::memset( m_base + end, 0, static_cast<std::size_t>( file_size - end ) );
+				m_tail.store( end );
+				m_flushed = end;
+			}
+		};
+#endif
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,487 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/sigpipe.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+#include "daw_burp_framing.h"
+
+#include <daw/daw_span.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#if defined( DAW_HAS_UNISTD ) and __has_include( <sys/epoll.h> )
+#include <sys/epoll.h>
+#define DAW_BURP_HAS_EPOLL
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief A single threaded reactor over epoll.  Callbacks are one shot, they are removed
+		/// before being called and can register again.
+		class event_loop {
+			struct watcher {
+				std::function<void( )> on_readable{ };
+				std::function<void( )> on_writable{ };
+			};
+
+			int m_epoll;
+			std::unordered_map<int, watcher> m_watchers{ };
+
+			void update( int fd, bool is_new ) {
+				auto const pos = m_watchers.find( fd );
+				std::uint32_t events = 0;
+				if( pos->second.on_readable ) {
+					events |= EPOLLIN;
+				}
+				if( pos->second.on_writable ) {
+					events |= EPOLLOUT;
+				}
+				if( events == 0 ) {
+					(void)::epoll_ctl( m_epoll, EPOLL_CTL_DEL, fd, nullptr );
+					m_watchers.erase( pos );
+					return;
+				}
+				auto ev = epoll_event{ };
+				ev.events = events;
+				ev.data.fd = fd;
+				auto const ret = ::epoll_ctl( m_epoll, is_new ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev );
+				daw_burp_ensure( ret == 0, daw::burp::ErrorReason::InputError );
+			}
+
+			template<typename Function>
+			void watch( int fd, std::function<void( )> watcher::*slot, Function &&func ) {
+				auto const pos = m_watchers.find( fd );
+				bool const is_new = pos == m_watchers.end( );
+				auto &w = is_new ? m_watchers[fd] : pos->second;
+				daw_burp_ensure( not( w.*slot ), daw::burp::ErrorReason::InputError );
+				w.*slot = std::forward<Function>( func );
+				update( fd, is_new );
+			}
+
+		public:
+			event_loop( )
+			  : m_epoll( ::epoll_create1( EPOLL_CLOEXEC ) ) {
+				daw_burp_ensure( m_epoll >= 0, daw::burp::ErrorReason::InputError );
+			}
+
+			event_loop( event_loop const & ) = delete;
+			event_loop &operator=( event_loop const & ) = delete;
+
+			~event_loop( ) {
+				::close( m_epoll );
+			}
+
+			/// @brief Call func once the next time fd is readable
+			template<typename Function>
+			void watch_readable( int fd, Function &&func ) {
+				watch( fd, &watcher::on_readable, std::forward<Function>( func ) );
+			}
+
+			/// @brief Call func once the next time fd is writable
+			template<typename Function>
+			void watch_writable( int fd, Function &&func ) {
+				watch( fd, &watcher::on_writable, std::forward<Function>( func ) );
+			}
+
+			/// @brief Are there callbacks waiting
+			[[nodiscard]] bool empty( ) const noexcept {
+				return m_watchers.empty( );
+			}
+
+			/// @brief Wait up to timeout_ms, -1 for no limit, and call the callbacks of the ready
+			/// descriptors.  Returns the number of callbacks called
+			std::size_t run_once( int timeout_ms = -1 ) {
+				epoll_event events[64];
+				auto const count = ::epoll_wait( m_epoll, events, 64, timeout_ms );
+				if( count < 0 ) {
+					daw_burp_ensure( errno == EINTR, daw::burp::ErrorReason::InputError );
+					return 0;
+				}
+				std::size_t called = 0;
+				for( int n = 0; n < count; ++n ) {
+					auto const fd = events[n].data.fd;
+					auto const pos = m_watchers.find( fd );
+					if( pos == m_watchers.end( ) ) {
+						continue;
+					}
+					auto const ev = events[n].events;
+					auto const is_error = ( ev & ( EPOLLERR | EPOLLHUP ) ) != 0;
+					auto on_readable = std::function<void( )>( );
+					auto on_writable = std::function<void( )>( );
+					if( is_error or ( ev & EPOLLIN ) != 0 ) {
+						on_readable = std::exchange( pos->second.on_readable, nullptr );
+					}
+					if( is_error or ( ev & EPOLLOUT ) != 0 ) {
+						on_writable = std::exchange( pos->second.on_writable, nullptr );
+					}
+					update( fd, false );
+					if( on_readable ) {
+						on_readable( );
+						++called;
+					}
+					if( on_writable ) {
+						on_writable( );
+						++called;
+					}
+				}
+				return called;
+			}
+
+			/// @brief Dispatch callbacks until none are waiting
+			void run( ) {
+				while( not empty( ) ) {
+					(void)run_once( );
+				}
+			}
+		};
+
+		namespace burp_impl {
+			template<typename Result>
+			struct async_state {
+				std::optional<Result> result{ };
+				std::exception_ptr error{ };
+				std::function<void( )> continuation{ };
+
+				[[nodiscard]] bool is_ready( ) const noexcept {
+					return result.has_value( ) or error;
+				}
+
+				void finish( ) {
+					if( continuation ) {
+						std::exchange( continuation, nullptr )( );
+					}
+				}
+			};
+
+			/// Writable ranges that visit_impl1 encodes as a count followed by each element
+			template<typename T>
+			inline constexpr bool is_element_wise_range_v = [] {
+				if constexpr( has_generic_dto_v<T> or is_string_table_v<T> or is_bool_vector_v<T> or
+				              is_bitset_v<T> or is_indexed_container_v<T> or is_aligned_container_v<T> ) {
+					return false;
+				} else if constexpr( is_contiguous_array_of_fundamental_like_types_v<T> or
+				                     is_segmented_bulk_container_v<T> ) {
+					return false;
+				} else {
+					return concepts::is_writable_range_v<T>;
+				}
+			}( );
+
+			template<typename T, bool = is_element_wise_range_v<T>>
+			struct chunk_cursor {};
+
+			template<typename T>
+			struct chunk_cursor<T, true> {
+				std::optional<decltype( std::begin( std::declval<T const &>( ) ) )> first{ };
+				std::optional<decltype( std::end( std::declval<T const &>( ) ) )> last{ };
+			};
+
+			/// Appends the encoding of value to a buffer a piece at a time.  Ranges are split between
+			/// elements, anything else is encoded in one piece
+			template<typename T>
+			class chunked_encoder {
+				T const *m_value;
+				chunk_cursor<T> m_cursor{ };
+				/// Bytes appended so far.  Elements are visited one at a time, so the offset that
+				/// aligned_container's pad against is carried between them
+				std::size_t m_offset = 0;
+
+			public:
+				explicit chunked_encoder( T const &value )
+				  : m_value( &value ) {}
+
+				/// Append at least chunk_size bytes, unless the value ends first.  Returns false once
+				/// everything is appended
+				bool append_chunk( std::string &buffer, std::size_t chunk_size ) {
+					auto append_blobs = [&]( auto const &...blobs ) {
+						constexpr auto add = []( std::string &b, auto const &blob ) {
+							b.append( reinterpret_cast<char const *>( std::data( blob ) ), std::size( blob ) );
+							return 0;
+						};
+						(void)( add( buffer, blobs ) | ... );
+					};
+					auto const append = [&]( auto const &v ) {
+						auto counted = offset_visitor<decltype( append_blobs )>{ &append_blobs, m_offset };
+						visit_impl1( counted, v );
+						m_offset = counted.offset;
+					};
+					if constexpr( is_element_wise_range_v<T> ) {
+						auto &first = m_cursor.first;
+						auto &last = m_cursor.last;
+						if( not first ) {
+							auto const sz = concepts::container_size( *m_value );
+							buffer.append( reinterpret_cast<char const *>( &sz ), sizeof( sz ) );
+							m_offset = sizeof( sz );
+							first.emplace( std::begin( *m_value ) );
+							last.emplace( std::end( *m_value ) );
+						}
+						while( *first != *last and buffer.size( ) < chunk_size ) {
+							append( **first );
+							++*first;
+						}
+						return *first != *last;
+					} else {
+						append( *m_value );
+						return false;
+					}
+				}
+			};
+		} // namespace burp_impl
+
+		/// @brief The eventual result of an asynchronous read or write.  It is awaitable, so with
+		/// C++20 coroutines co_await resumes the coroutine on the event loop thread once the
+		/// operation completes.  Without coroutines, then( ) registers a callback instead.
+		template<typename Result>
+		class async_result {
+			std::shared_ptr<burp_impl::async_state<Result>> m_state;
+
+		public:
+			explicit async_result( std::shared_ptr<burp_impl::async_state<Result>> state ) noexcept
+			  : m_state( std::move( state ) ) {}
+
+			[[nodiscard]] bool is_ready( ) const noexcept {
+				return m_state->is_ready( );
+			}
+
+			/// @brief The result, rethrowing the error of a failed operation.  Only valid once ready
+			Result get( ) {
+				if( m_state->error ) {
+					std::rethrow_exception( m_state->error );
+				}
+				return std::move( *m_state->result );
+			}
+
+			/// @brief Call func with this once it is ready, immediately when it already is
+			template<typename Function>
+			void then( Function func ) {
+				if( is_ready( ) ) {
+					func( *this );
+					return;
+				}
+				m_state->continuation = [self = *this, func = std::move( func )]( ) mutable {
+					func( self );
+				};
+			}
+
+			[[nodiscard]] bool await_ready( ) const noexcept {
+				return is_ready( );
+			}
+
+			template<typename CoroutineHandle>
+			void await_suspend( CoroutineHandle handle ) {
+				m_state->continuation = [handle]( ) mutable {
+					handle.resume( );
+				};
+			}
+
+			Result await_resume( ) {
+				return get( );
+			}
+		};
+
+		/// @brief Writes values as frames, readable by frame_reader, to a non-blocking descriptor
+		/// driven by an event_loop.  Ranges are encoded chunk_size bytes at a time and the writer
+		/// goes back to the loop between chunks so that a large value does not hold up the other
+		/// descriptors.  One write is in flight at a time and the value must outlive it.  A peer
+		/// that has closed fails the write with OutputError rather than raising SIGPIPE.
+		class async_writer {
+			event_loop *m_loop;
+			concepts::fd_t m_fd;
+			std::size_t m_chunk_size;
+			std::shared_ptr<bool> m_is_busy = std::make_shared<bool>( false );
+
+			template<typename T>
+			struct operation : std::enable_shared_from_this<operation<T>> {
+				event_loop *loop;
+				concepts::fd_t fd;
+				bool is_socket;
+				std::size_t chunk_size;
+				std::shared_ptr<bool> is_busy;
+				burp_impl::chunked_encoder<T> encoder;
+				std::shared_ptr<burp_impl::async_state<std::size_t>> state;
+				std::string buffer{ };
+				std::size_t sent = 0;
+				std::size_t total = 0;
+				bool has_more = true;
+
+				operation( event_loop &l,
+				           concepts::fd_t f,
+				           std::size_t chunk,
+				           std::shared_ptr<bool> busy,
+				           T const &value )
+				  : loop( &l )
+				  , fd( f )
+				  , is_socket( burp_impl::is_socket_fd( f.value ) )
+				  , chunk_size( chunk )
+				  , is_busy( std::move( busy ) )
+				  , encoder( value )
+				  , state( std::make_shared<burp_impl::async_state<std::size_t>>( ) ) {
+					auto const size = static_cast<burp_impl::frame_size_t>( daw::burp::calc_size( value ) );
+					buffer.append( reinterpret_cast<char const *>( &size ), sizeof( size ) );
+					total = sizeof( size ) + static_cast<std::size_t>( size );
+					has_more = encoder.append_chunk( buffer, chunk_size );
+				}
+
+				void suspend( ) {
+					loop->watch_writable( fd.value, [self = this->shared_from_this( )] { self->step( ); } );
+				}
+
+				void complete( ) {
+					*is_busy = false;
+					state->finish( );
+				}
+
+				void step( ) {
+					try {
+						if( sent == buffer.size( ) ) {
+							if( not has_more ) {
+								state->result = total;
+								complete( );
+								return;
+							}
+							buffer.clear( );
+							sent = 0;
+							has_more = encoder.append_chunk( buffer, chunk_size );
+						}
+						auto const no_sigpipe =
+						  burp_impl::sigpipe_blocker( burp_impl::needs_sigpipe_blocker( is_socket ) );
+						while( sent < buffer.size( ) ) {
+							auto iov = iovec{ buffer.data( ) + sent, buffer.size( ) - sent };
+							auto const ret = burp_impl::write_iov( fd.value, is_socket, &iov, 1 );
+							if( ret < 0 ) {
+								if( errno == EINTR ) {
+									continue;
+								}
+								daw_burp_ensure( errno == EAGAIN or errno == EWOULDBLOCK,
+								                 daw::burp::ErrorReason::OutputError );
+								break;
+							}
+							sent += static_cast<std::size_t>( ret );
+						}
+						// Back to the loop when the descriptor is full and between chunks
+						if( sent < buffer.size( ) or has_more ) {
+							suspend( );
+							return;
+						}
+						state->result = total;
+						complete( );
+					} catch( ... ) {
+						state->error = std::current_exception( );
+						complete( );
+					}
+				}
+			};
+
+		public:
+			static constexpr std::size_t default_chunk_size = 64ULL * 1024ULL;
+
+			async_writer( event_loop &loop,
+			              concepts::fd_t fd,
+			              std::size_t chunk_size = default_chunk_size ) noexcept
+			  : m_loop( &loop )
+			  , m_fd( fd )
+			  , m_chunk_size( chunk_size ) {}
+
+			/// @brief Start writing value as one frame.  The result is the number of bytes written
+			template<typename T>
+			[[nodiscard]] async_result<std::size_t> write( T const &value ) {
+				daw_burp_ensure( not *m_is_busy, daw::burp::ErrorReason::OutputError );
+				*m_is_busy = true;
+				auto op = std::make_shared<operation<T>>( *m_loop, m_fd, m_chunk_size, m_is_busy, value );
+				auto result = async_result<std::size_t>( op->state );
+				op->step( );
+				return result;
+			}
+		};
+
+		/// @brief Reads frames from a non-blocking descriptor driven by an event_loop, waiting on the
+		/// loop whenever the next frame has not fully arrived.  One read is in flight at a time.
+		class async_reader {
+			event_loop *m_loop;
+			concepts::fd_t m_fd;
+			std::shared_ptr<frame_reader> m_frames;
+			std::shared_ptr<bool> m_is_busy = std::make_shared<bool>( false );
+
+			template<typename T>
+			struct operation : std::enable_shared_from_this<operation<T>> {
+				event_loop *loop;
+				concepts::fd_t fd;
+				std::shared_ptr<frame_reader> frames;
+				std::shared_ptr<bool> is_busy;
+				std::shared_ptr<burp_impl::async_state<T>> state =
+				  std::make_shared<burp_impl::async_state<T>>( );
+
+				operation( event_loop &l,
+				           concepts::fd_t f,
+				           std::shared_ptr<frame_reader> fr,
+				           std::shared_ptr<bool> busy )
+				  : loop( &l )
+				  , fd( f )
+				  , frames( std::move( fr ) )
+				  , is_busy( std::move( busy ) ) {}
+
+				void step( ) {
+					try {
+						auto value = frames->next<T>( );
+						if( not value ) {
+							(void)frames->fill( );
+							value = frames->next<T>( );
+						}
+						if( value ) {
+							state->result.emplace( std::move( *value ) );
+						} else {
+							daw_burp_ensure( not frames->is_closed( ), daw::burp::ErrorReason::InputError );
+							loop->watch_readable( fd.value,
+							                      [self = this->shared_from_this( )] { self->step( ); } );
+							return;
+						}
+					} catch( ... ) {
+						state->error = std::current_exception( );
+					}
+					*is_busy = false;
+					state->finish( );
+				}
+			};
+
+		public:
+			async_reader( event_loop &loop,
+			              concepts::fd_t fd,
+			              std::size_t buffer_size = frame_reader::default_buffer_size )
+			  : m_loop( &loop )
+			  , m_fd( fd )
+			  , m_frames( std::make_shared<frame_reader>( fd, buffer_size ) ) {}
+
+			/// @brief Start reading the next frame as a T
+			template<typename T>
+			[[nodiscard]] async_result<T> read( ) {
+				daw_burp_ensure( not *m_is_busy, daw::burp::ErrorReason::InputError );
+				*m_is_busy = true;
+				auto op = std::make_shared<operation<T>>( *m_loop, m_fd, m_frames, m_is_busy );
+				auto result = async_result<T>( op->state );
+				op->step( );
+				return result;
+			}
+		};
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
@@ -0,0 +1,413 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+
+#include <daw/daw_span.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		struct buffer_pool_stats {
+			/// Number of blocks handed out
+			std::size_t acquires = 0;
+			/// Number of acquires satisfied by a retained block
+			std::size_t hits = 0;
+			/// Number of blocks given back to the pool
+			std::size_t releases = 0;
+			/// Number of retained blocks freed by trimming or the retained byte limit
+			std::size_t trimmed = 0;
+			std::size_t blocks_retained = 0;
+			std::size_t bytes_retained = 0;
+
+			[[nodiscard]] constexpr double hit_rate( ) const noexcept {
+				if( acquires == 0 ) {
+					return 0.0;
+				}
+				return static_cast<double>( hits ) / static_cast<double>( acquires );
+			}
+		};
+
+		class buffer_pool;
+
+		namespace burp_impl {
+			inline constexpr std::size_t buffer_pool_class_count = 24U;
+
+			/// The part of a buffer_pool that its blocks refer to.  It is reference counted by the pool
+			/// and each outstanding block, so that a block can outlive its pool or be released from
+			/// another thread without touching the pool
+			struct buffer_pool_state {
+				/// Null once the pool is destroyed.  Only the owner thread releases through it
+				std::atomic<buffer_pool *> pool;
+				std::thread::id owner = std::this_thread::get_id( );
+				std::atomic<std::size_t> references{ 1 };
+				/// Blocks of each size class freed by other threads, for the owner to take out of its
+				/// in use counts
+				std::array<std::atomic<std::size_t>, buffer_pool_class_count> foreign_releases{ };
+
+				explicit buffer_pool_state( buffer_pool *p ) noexcept
+				  : pool( p ) {}
+
+				void add_reference( ) noexcept {
+					references.fetch_add( 1, std::memory_order_relaxed );
+				}
+
+				void remove_reference( ) noexcept {
+					if( references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+						delete this;
+					}
+				}
+			};
+		} // namespace burp_impl
+
+		/// @brief An owning handle to a block of memory from a buffer_pool.  The block goes back to the
+		/// pool when the handle is destroyed or reset on the pool's thread.  Otherwise, including when
+		/// the pool no longer exists, it is freed
+		class pooled_block {
+			friend class buffer_pool;
+
+			burp_impl::buffer_pool_state *m_state = nullptr;
+			char *m_data = nullptr;
+			std::size_t m_capacity = 0;
+
+			pooled_block( burp_impl::buffer_pool_state *state,
+			              char *data,
+			              std::size_t capacity ) noexcept
+			  : m_state( state )
+			  , m_data( data )
+			  , m_capacity( capacity ) {
+				m_state->add_reference( );
+			}
+
+		public:
+			pooled_block( ) = default;
+
+			pooled_block( pooled_block &&other ) noexcept
+			  : m_state( std::exchange( other.m_state, nullptr ) )
+			  , m_data( std::exchange( other.m_data, nullptr ) )
+			  , m_capacity( std::exchange( other.m_capacity, 0 ) ) {}
+
+			pooled_block &operator=( pooled_block &&rhs ) noexcept {
+				if( this != &rhs ) {
+					reset( );
+					m_state = std::exchange( rhs.m_state, nullptr );
+					m_data = std::exchange( rhs.m_data, nullptr );
+					m_capacity = std::exchange( rhs.m_capacity, 0 );
+				}
+				return *this;
+			}
+
+			pooled_block( pooled_block const & ) = delete;
+			pooled_block &operator=( pooled_block const & ) = delete;
+
+			~pooled_block( ) {
+				reset( );
+			}
+
+			[[nodiscard]] char *data( ) const noexcept {
+				return m_data;
+			}
+
+			[[nodiscard]] std::size_t capacity( ) const noexcept {
+				return m_capacity;
+			}
+
+			explicit operator bool( ) const noexcept {
+				return m_data != nullptr;
+			}
+
+			inline void reset( ) noexcept;
+		};
+
+		/// @brief A pool of output blocks bucketed by power of two size classes.  A pool is meant to be
+		/// used from a single thread, see thread_local_buffer_pool.  Blocks released from another
+		/// thread, or after the pool is destroyed, are freed instead of being retained.  The number of
+		/// blocks kept in each size class adapts to the peak number outstanding since the last trim.
+		class buffer_pool {
+			friend class pooled_block;
+
+			static constexpr std::size_t min_class_bits = 8U;
+			static constexpr std::size_t class_count = burp_impl::buffer_pool_class_count;
+
+			struct bucket {
+				std::vector<std::unique_ptr<char[]>> free_list{ };
+				std::size_t in_use = 0;
+				std::size_t peak_in_use = 0;
+			};
+
+			std::array<bucket, class_count> m_buckets{ };
+			buffer_pool_stats m_stats{ };
+			burp_impl::buffer_pool_state *m_state;
+			std::size_t m_max_bytes_retained;
+			std::size_t m_trim_interval;
+			std::size_t m_releases_since_trim = 0;
+
+			static constexpr std::size_t size_class( std::size_t size ) noexcept {
+				std::size_t bits = min_class_bits;
+				while( bits < ( sizeof( std::size_t ) * 8U - 1U ) and
+				       ( std::size_t{ 1 } << bits ) < size ) {
+					++bits;
+				}
+				return bits - min_class_bits;
+			}
+
+			static constexpr std::size_t class_capacity( std::size_t cls ) noexcept {
+				return std::size_t{ 1 } << ( cls + min_class_bits );
+			}
+
+			/// Called on the owner thread only
+			void release( char *data, std::size_t capacity ) noexcept {
+				auto ptr = std::unique_ptr<char[]>( data );
+				auto const cls = size_class( capacity );
+				++m_stats.releases;
+				if( cls >= class_count ) {
+					return;
+				}
+				auto &b = m_buckets[cls];
+				--b.in_use;
+				if( m_stats.bytes_retained + capacity > m_max_bytes_retained ) {
+					++m_stats.trimmed;
+					return;
+				}
+				try {
+					b.free_list.push_back( std::move( ptr ) );
+				} catch( ... ) {
+					return;
+				}
+				++m_stats.blocks_retained;
+				m_stats.bytes_retained += capacity;
+				if( ++m_releases_since_trim >= m_trim_interval ) {
+					trim( );
+				}
+			}
+
+		public:
+			static constexpr std::size_t default_max_bytes_retained = 64ULL * 1024ULL * 1024ULL;
+			static constexpr std::size_t default_trim_interval = 4096U;
+
+			explicit buffer_pool( std::size_t max_bytes_retained = default_max_bytes_retained,
+			                      std::size_t trim_interval = default_trim_interval )
+			  : m_state( new burp_impl::buffer_pool_state( this ) )
+			  , m_max_bytes_retained( max_bytes_retained )
+			  , m_trim_interval( trim_interval > 0 ? trim_interval : 1 ) {}
+
+			buffer_pool( buffer_pool const & ) = delete;
+			buffer_pool &operator=( buffer_pool const & ) = delete;
+
+			/// @brief Outstanding blocks stay valid and are freed when released
+			~buffer_pool( ) {
+				m_state->pool.store( nullptr, std::memory_order_release );
+				m_state->remove_reference( );
+			}
+
+			/// @brief Get a block with a capacity of at least min_size.  Sizes larger than the largest
+			/// size class are allocated exactly and freed on release
+			[[nodiscard]] pooled_block acquire( std::size_t min_size ) {
+				auto const cls = size_class( min_size );
+				++m_stats.acquires;
+				if( cls >= class_count ) {
+					return pooled_block( m_state, new char[min_size], min_size );
+				}
+				auto &b = m_buckets[cls];
+				auto const capacity = class_capacity( cls );
+				char *result = nullptr;
+				if( not b.free_list.empty( ) ) {
+					result = b.free_list.back( ).release( );
+					b.free_list.pop_back( );
+					++m_stats.hits;
+					--m_stats.blocks_retained;
+					m_stats.bytes_retained -= capacity;
+				} else {
+					result = new char[capacity];
+				}
+				++b.in_use;
+				if( b.in_use > b.peak_in_use ) {
+					b.peak_in_use = b.in_use;
+				}
+				return pooled_block( m_state, result, capacity );
+			}
+
+			/// @brief Free the retained blocks that were not needed to satisfy the peak demand of each
+			/// size class since the last trim
+			void trim( ) noexcept {
+				m_releases_since_trim = 0;
+				for( std::size_t cls = 0; cls < class_count; ++cls ) {
+					auto &b = m_buckets[cls];
+					auto const foreign =
+					  m_state->foreign_releases[cls].exchange( 0, std::memory_order_relaxed );
+					m_stats.releases += foreign;
+					b.in_use -= foreign;
+					auto const keep = b.peak_in_use > b.in_use ? b.peak_in_use - b.in_use : 0;
+					while( b.free_list.size( ) > keep ) {
+						b.free_list.pop_back( );
+						++m_stats.trimmed;
+						--m_stats.blocks_retained;
+						m_stats.bytes_retained -= class_capacity( cls );
+					}
+					b.peak_in_use = b.in_use;
+				}
+			}
+
+			/// @brief Free all retained blocks
+			void clear( ) noexcept {
+				for( std::size_t cls = 0; cls < class_count; ++cls ) {
+					m_stats.trimmed += m_buckets[cls].free_list.size( );
+					m_buckets[cls].free_list.clear( );
+				}
+				m_stats.blocks_retained = 0;
+				m_stats.bytes_retained = 0;
+			}
+
+			[[nodiscard]] buffer_pool_stats const &stats( ) const noexcept {
+				return m_stats;
+			}
+		};
+
+		void pooled_block::reset( ) noexcept {
+			if( m_data == nullptr ) {
+				return;
+			}
+			auto *const state = std::exchange( m_state, nullptr );
+			auto *const data = std::exchange( m_data, nullptr );
+			auto const capacity = std::exchange( m_capacity, 0 );
+			auto *const pool = std::this_thread::get_id( ) == state->owner
+			                     ? state->pool.load( std::memory_order_acquire )
+			                     : nullptr;
+			if( pool != nullptr ) {
+				pool->release( data, capacity );
+			} else {
+				delete[] data;
+				auto const cls = buffer_pool::size_class( capacity );
+				if( cls < burp_impl::buffer_pool_class_count ) {
+					state->foreign_releases[cls].fetch_add( 1, std::memory_order_relaxed );
+				}
+			}
+			state->remove_reference( );
+		}
+
+		/// @brief The calling thread's buffer pool
+		inline buffer_pool &thread_local_buffer_pool( ) {
+			thread_local auto pool = buffer_pool( );
+			return pool;
+		}
+
+		/// @brief A resizable writable output whose storage comes from a buffer_pool and goes back to
+		/// it on destruction, so that serializing many messages reuses the same memory.  It must not
+		/// grow after the pool is destroyed, destroying or releasing it is always safe
+		class pooled_output_buffer {
+			buffer_pool *m_pool;
+			pooled_block m_block{ };
+			std::size_t m_size = 0;
+
+		public:
+			using value_type = char;
+
+			explicit pooled_output_buffer( buffer_pool &pool = thread_local_buffer_pool( ) ) noexcept
+			  : m_pool( &pool ) {}
+
+			[[nodiscard]] char *data( ) noexcept {
+				return m_block.data( );
+			}
+
+			[[nodiscard]] char const *data( ) const noexcept {
+				return m_block.data( );
+			}
+
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			[[nodiscard]] bool empty( ) const noexcept {
+				return m_size == 0;
+			}
+
+			[[nodiscard]] std::size_t capacity( ) const noexcept {
+				return m_block.capacity( );
+			}
+
+			/// @brief The serialized bytes
+			[[nodiscard]] daw::span<char const> span( ) const noexcept {
+				return daw::span<char const>( data( ), m_size );
+			}
+
+			void reserve( std::size_t new_capacity ) {
+				if( new_capacity > capacity( ) ) {
+					auto next = m_pool->acquire( new_capacity );
+					if( m_size > 0 ) {
+						std::memcpy( next.data( ), m_block.data( ), m_size );
+					}
+					m_block = std::move( next );
+				}
+			}
+
+			void append( char const *ptr, std::size_t count ) {
+				reserve( m_size + count );
+				std::memcpy( m_block.data( ) + m_size, ptr, count );
+				m_size += count;
+			}
+
+			void push_back( char c ) {
+				append( &c, 1 );
+			}
+
+			/// @brief Empty the buffer but keep its block
+			void clear( ) noexcept {
+				m_size = 0;
+			}
+
+			/// @brief Empty the buffer and give its block back to the pool
+			void release( ) noexcept {
+				m_size = 0;
+				m_block.reset( );
+			}
+		};
+
+		namespace concepts {
+			/// @brief Specialization for pooled_output_buffer
+			template<>
+			struct writable_output_trait<pooled_output_buffer> : std::true_type {
+				static constexpr std::size_t capacity( pooled_output_buffer const & ) noexcept {
+					return std::numeric_limits<std::size_t>::max( );
+				}
+
+				static inline void reserve( pooled_output_buffer &out, std::size_t additional ) {
+					out.reserve( out.size( ) + additional );
+				}
+
+				template<typename... ContiguousBytes>
+				static inline void write( pooled_output_buffer &out, ContiguousBytes... blobs ) {
+					static_assert( sizeof...( ContiguousBytes ) > 0 );
+					constexpr auto writer = []( pooled_output_buffer &o, auto sv ) {
+						if( sv.empty( ) ) {
+							return 0;
+						}
+						o.append( reinterpret_cast<char const *>( std::data( sv ) ), std::size( sv ) );
+						return 0;
+					};
+					(void)( writer( out, blobs ) | ... );
+				}
+
+				static inline void put( pooled_output_buffer &out, char c ) {
+					out.push_back( c );
+				}
+			};
+		} // namespace concepts
+	}   // namespace DAW_BURP_VER
+} // namespace daw::burp
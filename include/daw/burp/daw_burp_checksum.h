@@ -0,0 +1,146 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/crc32c.h"
+#include "impl/version.h"
+
+#include "daw_burp.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief Size of the CRC32C trailer appended by write_with_checksum
+		inline constexpr std::size_t checksum_size = sizeof( std::uint32_t );
+
+		namespace burp_impl {
+			/// Readable adaptor that checksums the bytes as they are copied out of the input
+			template<typename Readable>
+			struct checksummed_input {
+				Readable &input;
+				std::uint32_t crc = 0;
+			};
+		} // namespace burp_impl
+
+		/// @brief A writable output that only computes the CRC32C of what is written to it.  Useful
+		/// as one of the sinks of a tee_output
+		struct crc32c_output {
+			std::uint32_t crc = 0;
+			std::size_t size = 0;
+		};
+
+		namespace concepts {
+			template<>
+			struct writable_output_trait<crc32c_output> : std::true_type {
+				static constexpr std::size_t capacity( crc32c_output const & ) noexcept {
+					return std::numeric_limits<std::size_t>::max( );
+				}
+
+				template<typename... ContiguousBytes>
+				static inline void write( crc32c_output &out, ContiguousBytes... blobs ) {
+					static_assert( sizeof...( ContiguousBytes ) > 0 );
+					( ( out.crc = crc32c( out.crc, std::data( blobs ), std::size( blobs ) ) ), ... );
+					out.size += ( std::size( blobs ) + ... );
+				}
+
+				static inline void put( crc32c_output &out, char c ) {
+					out.crc = crc32c( out.crc, &c, 1 );
+					++out.size;
+				}
+			};
+
+			template<typename Readable>
+			struct readable_input_trait<burp_impl::checksummed_input<Readable>> : std::true_type {
+				static inline void
+				read( burp_impl::checksummed_input<Readable> &in, char *dest, std::size_t count ) {
+					readable_input_trait<Readable>::read( in.input, dest, count );
+					in.crc = crc32c( in.crc, dest, count );
+				}
+
+				/// The size of the wrapped input, so that counts are checked before the checksum is
+				template<typename R = Readable,
+				         std::enable_if_t<has_readable_input_size_v<R>, std::nullptr_t> = nullptr>
+				static constexpr std::size_t
+				size( burp_impl::checksummed_input<Readable> const &in ) noexcept {
+					return readable_input_trait<R>::size( in.input );
+				}
+			};
+		} // namespace concepts
+
+		template<typename T>
+		std::size_t calc_size_with_checksum( T const &value ) {
+			return calc_size( value ) + checksum_size;
+		}
+
+		/// @brief Serialize value followed by a CRC32C of the serialized bytes.  The checksum is
+		/// computed on each blob as it is handed to the output, so the data is only traversed once
+		template<typename Writable, typename T>
+		std::size_t write_with_checksum( Writable &&writable, T const &value ) {
+			static_assert( concepts::is_writable_output_type_v<daw::remove_cvref_t<Writable>> );
+			using out_t = concepts::writable_output_trait<daw::remove_cvref_t<Writable>>;
+			auto const size_needed = calc_size_with_checksum( value );
+			daw_burp_ensure( size_needed <= out_t::capacity( writable ),
+			                 daw::burp::ErrorReason::OutputError );
+			if constexpr( concepts::has_writable_output_reserve_v<daw::remove_cvref_t<Writable>> ) {
+				out_t::reserve( writable, size_needed );
+			}
+			std::uint32_t crc = 0;
+			burp_impl::visit_impl1(
+			  [&]( auto const &...blobs ) {
+				  ( ( crc = crc32c( crc, std::data( blobs ), std::size( blobs ) ) ), ... );
+				  out_t::write( writable, blobs... );
+			  },
+			  value );
+			out_t::write( writable, daw::span( reinterpret_cast<char const *>( &crc ), sizeof( crc ) ) );
+			return size_needed;
+		}
+
+		/// @brief Deserialize a T written by write_with_checksum, verifying the trailer as part of the
+		/// same pass.  Throws ErrorReason::ChecksumError on a mismatch
+		template<typename T,
+		         typename Readable,
+		         typename Allocator,
+		         std::enable_if_t<not std::is_pointer_v<Allocator>, std::nullptr_t> = nullptr>
+		T read_with_checksum( Readable &&readable, Allocator const &alloc ) {
+			using in_t = daw::remove_cvref_t<Readable>;
+			static_assert( concepts::is_readable_input_type_v<in_t> );
+			auto const do_read = [&]( in_t &input ) {
+				auto in = burp_impl::checksummed_input<in_t>{ input };
+				auto result = burp_impl::read_impl1<T>( in, alloc );
+				std::uint32_t expected = 0;
+				concepts::readable_input_trait<in_t>::read(
+				  input, reinterpret_cast<char *>( &expected ), sizeof( expected ) );
+				daw_burp_ensure( expected == in.crc, daw::burp::ErrorReason::ChecksumError );
+				return result;
+			};
+			if constexpr( std::is_const_v<std::remove_reference_t<Readable>> ) {
+				auto input = in_t( readable );
+				return do_read( input );
+			} else {
+				return do_read( readable );
+			}
+		}
+
+		template<typename T, typename Readable>
+		T read_with_checksum( Readable &&readable ) {
+			return read_with_checksum<T>( DAW_FWD( readable ), burp_impl::default_allocator_t{ } );
+		}
+
+#if defined( DAW_BURP_HAS_PMR )
+		template<typename T, typename Readable>
+		T read_with_checksum( Readable &&readable, std::pmr::memory_resource *resource ) {
+			return read_with_checksum<T>( DAW_FWD( readable ),
+			                              std::pmr::polymorphic_allocator<std::byte>( resource ) );
+		}
+#endif
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,224 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_readable_input.h"
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+#include <daw/daw_traits.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			/// A delta of a mapped class is the number of changed members followed by the index of
+			/// each, in increasing order, and its new value.  Members that are mapped classes
+			/// themselves are encoded as a nested delta, everything else is encoded whole
+			using delta_tag_t = std::uint32_t;
+
+			template<typename T>
+			std::string encode_value( T const &value ) {
+				auto result = std::string( );
+				visit_impl1(
+				  [&]( auto const &...blobs ) {
+					  ( result.append( reinterpret_cast<char const *>( std::data( blobs ) ),
+					                   std::size( blobs ) ),
+					    ... );
+				  },
+				  value );
+				return result;
+			}
+
+			template<typename T>
+			bool delta_equal( T const &lhs, T const &rhs );
+
+			template<typename T, std::size_t... Is>
+			bool delta_equal_members( T const &lhs, T const &rhs, std::index_sequence<Is...> ) {
+				auto const lhs_tp = generic_dto<T>::to_tuple( lhs );
+				auto const rhs_tp = generic_dto<T>::to_tuple( rhs );
+				return ( delta_equal( std::get<Is>( lhs_tp ), std::get<Is>( rhs_tp ) ) and ... );
+			}
+
+			/// Do lhs and rhs have the same encoding.  Compares without encoding where the type allows
+			template<typename T>
+			bool delta_equal( T const &lhs, T const &rhs ) {
+				if constexpr( concepts::container_detect::is_fundamental_type_v<T> ) {
+					// Bitwise, so that e.g. a NaN is unchanged and -0.0 differs from 0.0
+					return std::memcmp( &lhs, &rhs, sizeof( T ) ) == 0;
+				} else if constexpr( is_bool_vector_v<T> ) {
+					return lhs == rhs;
+				} else if constexpr( has_generic_dto_v<T> ) {
+					return delta_equal_members(
+					  lhs, rhs, std::make_index_sequence<generic_dto<T>::member_count( )>{ } );
+				} else if constexpr( is_contiguous_array_of_fundamental_like_types_v<T> ) {
+					constexpr auto value_size = concepts::container_detect::container_value_type<T>::size;
+					auto const sz = std::size( lhs );
+					return sz == std::size( rhs ) and
+					       ( sz == 0 or
+					         std::memcmp( std::data( lhs ), std::data( rhs ), sz * value_size ) == 0 );
+				} else if constexpr( concepts::is_container_v<T> ) {
+					if( concepts::container_size( lhs ) != concepts::container_size( rhs ) ) {
+						return false;
+					}
+					auto first = std::begin( rhs );
+					for( auto const &element : lhs ) {
+						if( not delta_equal( element, *first ) ) {
+							return false;
+						}
+						++first;
+					}
+					return true;
+				} else {
+					return encode_value( lhs ) == encode_value( rhs );
+				}
+			}
+
+			template<typename T, std::size_t... Is>
+			delta_tag_t append_delta_members( std::string &out,
+			                                  T const &previous,
+			                                  T const &current,
+			                                  std::index_sequence<Is...> );
+
+			/// Append the delta of a mapped class to out.  Returns the number of changed members
+			template<typename T>
+			delta_tag_t append_delta( std::string &out, T const &previous, T const &current ) {
+				static_assert( has_generic_dto_v<T>, "Deltas are only supported for mapped classes" );
+				auto const count_pos = out.size( );
+				out.append( sizeof( delta_tag_t ), '\0' );
+				auto const count = append_delta_members(
+				  out, previous, current, std::make_index_sequence<generic_dto<T>::member_count( )>{ } );
+				std::memcpy( out.data( ) + count_pos, &count, sizeof( count ) );
+				return count;
+			}
+
+			template<typename T, std::size_t... Is>
+			delta_tag_t append_delta_members( std::string &out,
+			                                  T const &previous,
+			                                  T const &current,
+			                                  std::index_sequence<Is...> ) {
+				auto const previous_tp = generic_dto<T>::to_tuple( previous );
+				auto const current_tp = generic_dto<T>::to_tuple( current );
+				delta_tag_t count = 0;
+				auto const do_member = [&]( delta_tag_t index, auto const &prev, auto const &cur ) {
+					using member_t = DAW_TYPEOF( cur );
+					auto const tag_pos = out.size( );
+					out.append( reinterpret_cast<char const *>( &index ), sizeof( index ) );
+					if constexpr( has_generic_dto_v<member_t> ) {
+						if( append_delta( out, prev, cur ) == 0 ) {
+							out.resize( tag_pos );
+							return;
+						}
+					} else {
+						if( delta_equal( prev, cur ) ) {
+							out.resize( tag_pos );
+							return;
+						}
+						visit_impl1(
+						  [&]( auto const &...blobs ) {
+							  ( out.append( reinterpret_cast<char const *>( std::data( blobs ) ),
+							                std::size( blobs ) ),
+							    ... );
+						  },
+						  cur );
+					}
+					++count;
+				};
+				( do_member( static_cast<delta_tag_t>( Is ),
+				             std::get<Is>( previous_tp ),
+				             std::get<Is>( current_tp ) ),
+				  ... );
+				return count;
+			}
+
+			template<typename T, typename Readable>
+			void apply_delta_impl( Readable &in, T &value );
+
+			template<typename T, typename Readable, std::size_t... Is>
+			void apply_delta_members( Readable &in, T &value, std::index_sequence<Is...> ) {
+				static_assert( has_mutable_dto_members<T>( std::index_sequence<Is...>{ } ),
+				               "apply_delta requires the members of mapped classes to be assignable" );
+				using in_t = concepts::readable_input_trait<Readable>;
+				auto tp = generic_dto<T>::to_tuple( value );
+				delta_tag_t count = 0;
+				in_t::read( in, reinterpret_cast<char *>( &count ), sizeof( count ) );
+				daw_burp_ensure( count <= sizeof...( Is ), daw::burp::ErrorReason::InputError );
+				std::size_t next_index = 0;
+				for( delta_tag_t n = 0; n < count; ++n ) {
+					delta_tag_t index = 0;
+					in_t::read( in, reinterpret_cast<char *>( &index ), sizeof( index ) );
+					daw_burp_ensure( index >= next_index and index < sizeof...( Is ),
+					                 daw::burp::ErrorReason::InputError );
+					next_index = index + 1U;
+					auto const do_member = [&]( auto &member ) {
+						using member_t = DAW_TYPEOF( member );
+						if constexpr( has_generic_dto_v<member_t> ) {
+							apply_delta_impl( in, member );
+						} else {
+							read_into_impl1( in, member, default_allocator_t{ } );
+						}
+						return true;
+					};
+					(void)( ( index == Is and do_member( std::get<Is>( tp ) ) ) or ... );
+				}
+			}
+
+			template<typename T, typename Readable>
+			void apply_delta_impl( Readable &in, T &value ) {
+				apply_delta_members(
+				  in, value, std::make_index_sequence<generic_dto<T>::member_count( )>{ } );
+			}
+		} // namespace burp_impl
+
+		/// @brief Serialize only the members of current that differ from previous, recursing into
+		/// members that are mapped classes.  Applying the delta to a copy of previous with apply_delta
+		/// gives current.  Comparing skips encoding where it can, and the size of the delta is
+		/// proportional to what changed.  Returns the number of bytes written
+		template<typename Writable, typename T>
+		std::size_t write_delta( Writable &&writable, T const &previous, T const &current ) {
+			static_assert( concepts::is_writable_output_type_v<daw::remove_cvref_t<Writable>> );
+			using out_t = concepts::writable_output_trait<daw::remove_cvref_t<Writable>>;
+			auto delta = std::string( );
+			(void)burp_impl::append_delta( delta, previous, current );
+			daw_burp_ensure( delta.size( ) <= out_t::capacity( writable ),
+			                 daw::burp::ErrorReason::OutputError );
+			out_t::write( writable, daw::span<char const>( delta.data( ), delta.size( ) ) );
+			return delta.size( );
+		}
+
+		/// @brief Patch value with a delta written by write_delta.  value must be equal to the
+		/// previous value the delta was made against.  When readable is a mutable lvalue it is
+		/// advanced past the delta
+		template<typename T, typename Readable>
+		void apply_delta( Readable &&readable, T &value ) {
+			using in_t = daw::remove_cvref_t<Readable>;
+			static_assert( concepts::is_readable_input_type_v<in_t> );
+			static_assert( burp_impl::has_generic_dto_v<T>,
+			               "Deltas are only supported for mapped classes" );
+			if constexpr( std::is_const_v<std::remove_reference_t<Readable>> ) {
+				auto in = in_t( readable );
+				burp_impl::apply_delta_impl( in, value );
+			} else {
+				burp_impl::apply_delta_impl( readable, value );
+			}
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -14,7 +14,10 @@
 #include <boost/describe.hpp>
 #include <boost/mp11.hpp>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace daw::burp {
@@ -26,8 +29,86 @@ namespace daw::burp {
 
 			template<template<typename...> typename List, typename... Ts>
 			inline constexpr std::size_t member_list_size_v<List<Ts...>> = sizeof...( Ts );
+
+			template<typename Int, typename Value>
+			constexpr bool is_in_range( Value v ) noexcept {
+				if constexpr( std::is_signed_v<Value> ) {
+					if( v < 0 ) {
+						return std::is_signed_v<Int> and
+						       static_cast<std::intmax_t>( v ) >= std::numeric_limits<Int>::min( );
+					}
+				}
+				return static_cast<std::uintmax_t>( v ) <=
+				       static_cast<std::uintmax_t>( std::numeric_limits<Int>::max( ) );
+			}
+
+			template<typename Int, typename Value, std::size_t N>
+			constexpr bool all_in_range( Value const ( &values )[N] ) noexcept {
+				for( auto v : values ) {
+					if( not is_in_range<Int>( v ) ) {
+						return false;
+					}
+				}
+				return true;
+			}
+
+			/// The smallest integral type holding every enumerator of E, or its underlying type
+			template<typename E, typename... Ds>
+			struct enumerator_range_type {
+				using underlying_t = std::underlying_type_t<E>;
+				static constexpr underlying_t values[]{ static_cast<underlying_t>( Ds::value )... };
+
+				template<typename Int, typename... Ints>
+				static constexpr auto select( ) {
+					if constexpr( sizeof( Int ) >= sizeof( underlying_t ) ) {
+						return underlying_t{ };
+					} else if constexpr( all_in_range<Int>( values ) ) {
+						return Int{ };
+					} else if constexpr( sizeof...( Ints ) > 0 ) {
+						return select<Ints...>( );
+					} else {
+						return underlying_t{ };
+					}
+				}
+
+				using type = decltype( select<std::uint8_t,
+				                              std::int8_t,
+				                              std::uint16_t,
+				                              std::int16_t,
+				                              std::uint32_t,
+				                              std::int32_t>( ) );
+			};
+
+			template<typename E, typename List>
+			struct enumerator_list_range;
+
+			template<typename E, template<typename...> typename List, typename... Ds>
+			struct enumerator_list_range<E, List<Ds...>> {
+				using type = typename std::conditional_t<( sizeof...( Ds ) > 0 ),
+				                                         enumerator_range_type<E, Ds...>,
+				                                         std::underlying_type<E>>::type;
+			};
 		} // namespace describe_impl
 
+		namespace burp_impl {
+			template<typename T>
+			inline constexpr bool
+			  is_boost_described_v<T, std::enable_if_t<boost::describe::has_describe_members<T>::value>> =
+			    true;
+		} // namespace burp_impl
+
+		namespace concepts {
+			/// @brief Boost.Described enums are encoded as the smallest integral type that holds all of
+			/// their enumerators.  Values outside of that range fail to serialize.
+			template<typename E>
+			struct enum_encoding<E,
+			                     std::enable_if_t<boost::describe::has_describe_enumerators<E>::value and
+			                                      use_boost_describe_v<E>>> {
+				using type = typename describe_impl::
+				  enumerator_list_range<E, boost::describe::describe_enumerators<E>>::type;
+			};
+		} // namespace concepts
+
 		template<typename T>
 		struct generic_dto<T,
 		                   std::enable_if_t<boost::describe::has_describe_members<T>::value and
@@ -48,6 +129,11 @@ namespace daw::burp {
 				return std::forward_as_tuple( value.*Ts::pointer... );
 			}
 
+			template<template<typename...> typename List, typename... Ts>
+			static inline constexpr auto to_tuple_impl( T &value, List<Ts...> const & ) noexcept {
+				return std::forward_as_tuple( value.*Ts::pointer... );
+			}
+
 		public:
 			static DAW_CONSTEVAL std::size_t member_count( ) {
 				return describe_impl::member_list_size_v<pub_desc_t>;
@@ -56,6 +142,10 @@ namespace daw::burp {
 			static constexpr auto to_tuple( T const &value ) noexcept {
 				return to_tuple_impl( value, pub_desc_t{ } );
 			}
+
+			static constexpr auto to_tuple( T &value ) noexcept {
+				return to_tuple_impl( value, pub_desc_t{ } );
+			}
 		};
 	} // namespace DAW_BURP_VER
 } // namespace daw::burp
\ No newline at end of file
@@ -0,0 +1,229 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_readable_input.h"
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+#include <daw/daw_traits.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			/// The distinct strings of a value in order of first appearance.  The string_views refer
+			/// to the value being written
+			class string_dictionary {
+				std::unordered_map<std::string_view, std::uint32_t> m_codes{ };
+				std::vector<std::string_view> m_entries{ };
+
+			public:
+				void intern( std::string_view str ) {
+					if( m_codes.count( str ) == 0 ) {
+						daw_burp_ensure( m_entries.size( ) < std::numeric_limits<std::uint32_t>::max( ),
+						                 daw::burp::ErrorReason::OutputError );
+						m_codes.emplace( str, static_cast<std::uint32_t>( m_entries.size( ) ) );
+						m_entries.push_back( str );
+					}
+				}
+
+				[[nodiscard]] std::uint32_t code( std::string_view str ) const {
+					auto const pos = m_codes.find( str );
+					daw_burp_ensure( pos != m_codes.end( ), daw::burp::ErrorReason::OutputError );
+					return pos->second;
+				}
+
+				[[nodiscard]] std::vector<std::string_view> const &entries( ) const noexcept {
+					return m_entries;
+				}
+			};
+
+			/// Codes are as wide as the dictionary size needs
+			constexpr std::size_t dictionary_code_width( std::size_t entry_count ) noexcept {
+				if( entry_count <= std::size_t{ 1 } << 8U ) {
+					return sizeof( std::uint8_t );
+				} else if( entry_count <= std::size_t{ 1 } << 16U ) {
+					return sizeof( std::uint16_t );
+				}
+				return sizeof( std::uint32_t );
+			}
+
+			/// First pass, collects the strings without emitting anything
+			struct dictionary_collector {
+				string_dictionary *dictionary;
+
+				template<typename... ContiguousBytes>
+				constexpr void operator( )( ContiguousBytes const &... ) const noexcept {}
+
+				void string( std::string_view str ) const {
+					dictionary->intern( str );
+				}
+
+				/// Nothing is emitted while collecting, so the index tables need not be exact
+				[[nodiscard]] dictionary_collector measuring( measuring_visitor & ) const noexcept {
+					return *this;
+				}
+			};
+
+			/// Second pass, emits the code of each string and everything else as is
+			template<typename Visitor>
+			struct dictionary_emitter {
+				Visitor *visitor;
+				string_dictionary const *dictionary;
+				std::size_t code_width;
+
+				template<typename... ContiguousBytes>
+				void operator( )( ContiguousBytes const &...blobs ) const {
+					( *visitor )( blobs... );
+				}
+
+				void string( std::string_view str ) const {
+					char code[sizeof( std::uint32_t )];
+					store_table_entry( code, dictionary->code( str ), code_width );
+					( *visitor )( daw::span<char const>( code, code_width ) );
+				}
+
+				[[nodiscard]] dictionary_emitter<measuring_visitor>
+				measuring( measuring_visitor &counter ) const noexcept {
+					return dictionary_emitter<measuring_visitor>{ &counter, dictionary, code_width };
+				}
+			};
+
+			template<>
+			inline constexpr bool is_dictionary_visitor_v<dictionary_collector> = true;
+
+			template<typename Visitor>
+			inline constexpr bool is_dictionary_visitor_v<dictionary_emitter<Visitor>> = true;
+
+			/// Writes the dictionary as a string_table followed by value with its strings replaced by
+			/// codes
+			template<typename Visitor, typename T>
+			void visit_with_dictionary( Visitor &&visitor, T const &value ) {
+				auto dictionary = string_dictionary( );
+				visit_impl1( dictionary_collector{ &dictionary }, value );
+				visit_string_table( visitor, dictionary.entries( ) );
+				auto const emitter = dictionary_emitter<std::remove_reference_t<Visitor>>{
+				  &visitor, &dictionary, dictionary_code_width( dictionary.entries( ).size( ) ) };
+				visit_impl1( emitter, value );
+			}
+
+			/// Wraps a Readable that is positioned after the dictionary
+			template<typename Readable>
+			class dictionary_input {
+				Readable *m_in;
+				std::vector<std::string> m_entries;
+				std::size_t m_code_width;
+
+			public:
+				explicit dictionary_input( Readable &in )
+				  : m_in( &in )
+				  , m_entries( read_impl1<string_table<std::vector<std::string>>>(
+				      in, default_allocator_t{ } ) )
+				  , m_code_width( dictionary_code_width( m_entries.size( ) ) ) {}
+
+				[[nodiscard]] Readable &input( ) noexcept {
+					return *m_in;
+				}
+
+				[[nodiscard]] std::string_view read_string( ) {
+					char buff[sizeof( std::uint32_t )];
+					concepts::readable_input_trait<Readable>::read( *m_in, buff, m_code_width );
+					auto const code = load_table_entry( buff, m_code_width );
+					daw_burp_ensure( code < m_entries.size( ), daw::burp::ErrorReason::InputError );
+					return m_entries[static_cast<std::size_t>( code )];
+				}
+			};
+
+			template<typename Readable>
+			inline constexpr bool is_dictionary_input_v<dictionary_input<Readable>> = true;
+		} // namespace burp_impl
+
+		namespace concepts {
+			/// @brief Specialization for reading dictionary encoded data
+			template<typename Readable>
+			struct readable_input_trait<burp_impl::dictionary_input<Readable>> : std::true_type {
+				static inline void read( burp_impl::dictionary_input<Readable> &in,
+				                         char *dest,
+				                         std::size_t count ) {
+					readable_input_trait<Readable>::read( in.input( ), dest, count );
+				}
+
+				static inline void skip( burp_impl::dictionary_input<Readable> &in, std::size_t count ) {
+					burp_impl::skip_bytes( in.input( ), count );
+				}
+			};
+		} // namespace concepts
+
+		/// @brief Size of value when written with write_with_dictionary
+		template<typename T>
+		std::size_t calc_size_with_dictionary( T const &value ) {
+			std::size_t result = 0;
+			burp_impl::visit_with_dictionary(
+			  [&]( auto const &...blobs ) { result += ( std::size( blobs ) + ... ); },
+			  value );
+			return result;
+		}
+
+		/// @brief Serialize value with each distinct string written once.  A dictionary of the
+		/// strings comes first and every occurrence of a string, including map keys, is replaced by
+		/// its 1, 2 or 4 byte code.  Read it back with read_with_dictionary.
+		template<typename Writable, typename T>
+		std::size_t write_with_dictionary( Writable &&writable, T const &value ) {
+			static_assert( concepts::is_writable_output_type_v<daw::remove_cvref_t<Writable>> );
+			using out_t = concepts::writable_output_trait<daw::remove_cvref_t<Writable>>;
+			// Encoding into a buffer first avoids collecting the dictionary twice
+			auto buffer = std::string( );
+			burp_impl::visit_with_dictionary(
+			  [&]( auto const &...blobs ) {
+				  constexpr auto append = []( std::string &b, auto const &blob ) {
+					  b.append( reinterpret_cast<char const *>( std::data( blob ) ), std::size( blob ) );
+					  return 0;
+				  };
+				  (void)( append( buffer, blobs ) | ... );
+			  },
+			  value );
+			daw_burp_ensure( buffer.size( ) <= out_t::capacity( writable ),
+			                 daw::burp::ErrorReason::OutputError );
+			if constexpr( concepts::has_writable_output_reserve_v<daw::remove_cvref_t<Writable>> ) {
+				out_t::reserve( writable, buffer.size( ) );
+			}
+			out_t::write( writable, daw::span<char const>( buffer.data( ), buffer.size( ) ) );
+			return buffer.size( );
+		}
+
+		/// @brief Deserialize a T written by write_with_dictionary.  Each distinct string is decoded
+		/// once and copied for each occurrence
+		template<typename T, typename Readable>
+		[[nodiscard]] T read_with_dictionary( Readable &&readable ) {
+			using in_t = daw::remove_cvref_t<Readable>;
+			static_assert( concepts::is_readable_input_type_v<in_t> );
+			if constexpr( std::is_const_v<std::remove_reference_t<Readable>> ) {
+				auto in = in_t( readable );
+				auto dict_in = burp_impl::dictionary_input<in_t>( in );
+				return burp_impl::read_impl1<T>( dict_in, burp_impl::default_allocator_t{ } );
+			} else {
+				auto dict_in = burp_impl::dictionary_input<in_t>( readable );
+				return burp_impl::read_impl1<T>( dict_in, burp_impl::default_allocator_t{ } );
+			}
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,280 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/sigpipe.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if defined( DAW_HAS_UNISTD )
+#include <climits>
+#include <sys/uio.h>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			/// Each frame is its length followed by that many bytes
+			using frame_size_t = std::uint64_t;
+
+			inline constexpr std::size_t frame_iov_max =
+#if defined( IOV_MAX )
+			  IOV_MAX;
+#else
+			  16;
+#endif
+		} // namespace burp_impl
+
+		/// @brief Packs length prefixed messages for a socket or pipe and sends everything queued
+		/// with as few writev calls as possible.  Works with blocking and non-blocking descriptors,
+		/// a flush that would block keeps the unsent bytes for the next one.  A peer that has closed
+		/// is reported as OutputError rather than by SIGPIPE.
+		class frame_writer {
+			/// Either a range of m_buffer or bytes owned by the caller
+			struct segment {
+				char const *external;
+				std::size_t offset;
+				std::size_t size;
+			};
+
+			concepts::fd_t m_fd;
+			bool m_is_socket;
+			std::string m_buffer{ };
+			std::vector<segment> m_segments{ };
+			std::size_t m_first_segment = 0;
+			std::size_t m_first_offset = 0;
+			std::size_t m_pending = 0;
+
+			void add_buffered( std::size_t offset, std::size_t size ) {
+				if( not m_segments.empty( ) and m_segments.back( ).external == nullptr and
+				    m_segments.back( ).offset + m_segments.back( ).size == offset ) {
+					m_segments.back( ).size += size;
+				} else {
+					m_segments.push_back( segment{ nullptr, offset, size } );
+				}
+				m_pending += size;
+			}
+
+			void add_header( std::size_t size ) {
+				auto const header = static_cast<burp_impl::frame_size_t>( size );
+				auto const offset = m_buffer.size( );
+				m_buffer.append( reinterpret_cast<char const *>( &header ), sizeof( header ) );
+				add_buffered( offset, sizeof( header ) );
+			}
+
+		public:
+			explicit frame_writer( concepts::fd_t fd ) noexcept
+			  : m_fd( fd )
+			  , m_is_socket( burp_impl::is_socket_fd( fd.value ) ) {}
+
+			/// @brief Encode value as the next frame
+			template<typename T>
+			void push( T const &value ) {
+				auto const size = daw::burp::calc_size( value );
+				add_header( size );
+				auto const offset = m_buffer.size( );
+				m_buffer.resize( offset + size );
+				char *out = m_buffer.data( ) + offset;
+				burp_impl::visit_impl1(
+				  [&]( auto const &...blobs ) {
+					  concepts::writable_output_trait<char *>::write( out, blobs... );
+				  },
+				  value );
+				add_buffered( offset, size );
+			}
+
+			/// @brief Queue an already encoded message as the next frame without copying it.  message
+			/// must stay valid until a flush returns true
+			void push_encoded( daw::span<char const> message ) {
+				add_header( message.size( ) );
+				if( not message.empty( ) ) {
+					m_segments.push_back( segment{ message.data( ), 0, message.size( ) } );
+					m_pending += message.size( );
+				}
+			}
+
+			/// @brief Bytes queued but not yet sent
+			[[nodiscard]] std::size_t pending( ) const noexcept {
+				return m_pending;
+			}
+
+			/// @brief Send the queued frames.  Returns true when everything has been sent and false
+			/// when the descriptor is non-blocking and would block
+			bool flush( ) {
+				iovec iov[burp_impl::frame_iov_max];
+				auto const no_sigpipe =
+				  burp_impl::sigpipe_blocker( burp_impl::needs_sigpipe_blocker( m_is_socket ) );
+				while( m_pending > 0 ) {
+					std::size_t count = 0;
+					for( auto n = m_first_segment; n < m_segments.size( ) and count < std::size( iov );
+					     ++n, ++count ) {
+						auto const &seg = m_segments[n];
+						auto const skip = n == m_first_segment ? m_first_offset : 0;
+						char const *base = seg.external ? seg.external : m_buffer.data( ) + seg.offset;
+						iov[count].iov_base = const_cast<char *>( base + skip );
+						iov[count].iov_len = seg.size - skip;
+					}
+					auto const ret =
+					  burp_impl::write_iov( m_fd.value, m_is_socket, iov, static_cast<int>( count ) );
+					if( ret < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						if( errno == EAGAIN or errno == EWOULDBLOCK ) {
+							return false;
+						}
+						daw_burp_ensure( false, daw::burp::ErrorReason::OutputError );
+					}
+					auto sent = static_cast<std::size_t>( ret );
+					m_pending -= sent;
+					while( sent > 0 ) {
+						auto const left = m_segments[m_first_segment].size - m_first_offset;
+						if( sent < left ) {
+							m_first_offset += sent;
+							break;
+						}
+						sent -= left;
+						++m_first_segment;
+						m_first_offset = 0;
+					}
+				}
+				m_buffer.clear( );
+				m_segments.clear( );
+				m_first_segment = 0;
+				m_first_offset = 0;
+				return true;
+			}
+		};
+
+		/// @brief Reassembles length prefixed frames from a socket or pipe.  fill reads whatever is
+		/// available, non-blocking descriptors included, and next_frame hands out each complete
+		/// frame in place in the receive buffer.
+		class frame_reader {
+			concepts::fd_t m_fd;
+			std::vector<char> m_buffer;
+			std::size_t m_max_frame_size;
+			std::size_t m_begin = 0;
+			std::size_t m_end = 0;
+			bool m_is_closed = false;
+
+			/// Move the unconsumed bytes to the front and make room for the frame being assembled
+			void make_room( ) {
+				if( m_begin > 0 ) {
+					std::memmove( m_buffer.data( ), m_buffer.data( ) + m_begin, m_end - m_begin );
+					m_end -= m_begin;
+					m_begin = 0;
+				}
+				if( m_end >= sizeof( burp_impl::frame_size_t ) ) {
+					burp_impl::frame_size_t size = 0;
+					std::memcpy( &size, m_buffer.data( ), sizeof( size ) );
+					daw_burp_ensure( size <= m_max_frame_size, daw::burp::ErrorReason::InputError );
+					auto const needed = sizeof( size ) + static_cast<std::size_t>( size );
+					if( needed > m_buffer.size( ) ) {
+						m_buffer.resize( needed );
+					}
+				}
+				if( m_end == m_buffer.size( ) ) {
+					m_buffer.resize( m_buffer.size( ) * 2U );
+				}
+			}
+
+		public:
+			static constexpr std::size_t default_buffer_size = 64ULL * 1024ULL;
+			static constexpr std::size_t default_max_frame_size = 64ULL * 1024ULL * 1024ULL;
+
+			explicit frame_reader( concepts::fd_t fd,
+			                       std::size_t buffer_size = default_buffer_size,
+			                       std::size_t max_frame_size = default_max_frame_size )
+			  : m_fd( fd )
+			  , m_buffer( buffer_size > sizeof( burp_impl::frame_size_t )
+			                ? buffer_size
+			                : sizeof( burp_impl::frame_size_t ) )
+			  , m_max_frame_size( max_frame_size ) {}
+
+			/// @brief Read what is available until the descriptor would block, the buffer is full or
+			/// the peer closes.  Frames returned before are invalidated.  Returns the bytes read
+			std::size_t fill( ) {
+				make_room( );
+				std::size_t total = 0;
+				while( m_end < m_buffer.size( ) ) {
+					auto const ret =
+					  ::read( m_fd.value, m_buffer.data( ) + m_end, m_buffer.size( ) - m_end );
+					if( ret < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						if( errno == EAGAIN or errno == EWOULDBLOCK ) {
+							break;
+						}
+						daw_burp_ensure( false, daw::burp::ErrorReason::InputError );
+					}
+					if( ret == 0 ) {
+						m_is_closed = true;
+						break;
+					}
+					m_end += static_cast<std::size_t>( ret );
+					total += static_cast<std::size_t>( ret );
+				}
+				return total;
+			}
+
+			/// @brief Has the peer closed its end
+			[[nodiscard]] bool is_closed( ) const noexcept {
+				return m_is_closed;
+			}
+
+			/// @brief Bytes received that are not part of a returned frame
+			[[nodiscard]] std::size_t buffered( ) const noexcept {
+				return m_end - m_begin;
+			}
+
+			/// @brief The next complete frame, valid until the next fill, or nothing when more bytes
+			/// are needed
+			[[nodiscard]] std::optional<daw::span<char const>> next_frame( ) {
+				auto const available = m_end - m_begin;
+				if( available < sizeof( burp_impl::frame_size_t ) ) {
+					return std::nullopt;
+				}
+				burp_impl::frame_size_t size = 0;
+				std::memcpy( &size, m_buffer.data( ) + m_begin, sizeof( size ) );
+				daw_burp_ensure( size <= m_max_frame_size, daw::burp::ErrorReason::InputError );
+				if( available - sizeof( size ) < size ) {
+					return std::nullopt;
+				}
+				auto const frame = daw::span<char const>( m_buffer.data( ) + m_begin + sizeof( size ),
+				                                          static_cast<std::size_t>( size ) );
+				m_begin += sizeof( size ) + static_cast<std::size_t>( size );
+				return frame;
+			}
+
+			/// @brief Deserialize the next complete frame as a T
+			template<typename T>
+			[[nodiscard]] std::optional<T> next( ) {
+				auto const frame = next_frame( );
+				if( not frame ) {
+					return std::nullopt;
+				}
+				return daw::burp::read<T>( *frame );
+			}
+		};
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
@@ -0,0 +1,218 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "daw_burp.h"
+#include "daw_burp_view.h"
+
+#include <daw/daw_span.h>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief Tuning for parallel_read.  Zero picks a default
+		struct parallel_read_options {
+			/// Threads decoding, including the calling one.  Defaults to the hardware concurrency
+			std::size_t thread_count = 0;
+			/// Elements handed out at a time.  Defaults to enough blocks for each thread to have
+			/// several, so that threads finishing early have something to steal
+			std::size_t block_size = 0;
+		};
+
+		namespace burp_impl {
+			inline constexpr std::size_t parallel_read_blocks_per_thread = 8;
+
+			/// The blocks of one worker.  The owner takes from the front and idle workers steal half of
+			/// what remains from the back
+			class parallel_block_queue {
+				std::mutex m_mutex{ };
+				std::size_t m_first = 0;
+				std::size_t m_last = 0;
+
+			public:
+				void assign( std::size_t first, std::size_t last ) {
+					auto const lck = std::lock_guard<std::mutex>( m_mutex );
+					m_first = first;
+					m_last = last;
+				}
+
+				/// Returns false when there are no blocks left
+				bool pop( std::size_t &block ) {
+					auto const lck = std::lock_guard<std::mutex>( m_mutex );
+					if( m_first == m_last ) {
+						return false;
+					}
+					block = m_first++;
+					return true;
+				}
+
+				/// Move half of victim's blocks to this empty queue
+				bool steal_from( parallel_block_queue &victim ) {
+					std::size_t first = 0;
+					std::size_t last = 0;
+					{
+						auto const lck = std::lock_guard<std::mutex>( victim.m_mutex );
+						auto const count = ( victim.m_last - victim.m_first + 1U ) / 2U;
+						if( count == 0 ) {
+							return false;
+						}
+						last = victim.m_last;
+						first = last - count;
+						victim.m_last = first;
+					}
+					assign( first, last );
+					return true;
+				}
+			};
+
+			/// The start of the encoding of the first element of each block followed by the end of the
+			/// elements.  The offset table or fixed element size is used when there is one, otherwise
+			/// the elements are skipped over without being decoded
+			template<typename Container>
+			std::vector<char const *>
+			parallel_block_bounds( encoded_span data, std::size_t size, std::size_t block_size ) {
+				using element_t = container_element_t<Container>;
+				auto result = std::vector<char const *>( );
+				result.reserve( ( size + block_size - 1U ) / block_size + 1U );
+				if constexpr( container_view<Container>::has_random_access ) {
+					auto const view = container_view<Container>( data );
+					for( std::size_t n = 0; n < size; n += block_size ) {
+						result.push_back( view.element_data( n ).data( ) );
+					}
+					auto const payload = view.payload( );
+					result.push_back( payload.data( ) + payload.size( ) );
+				} else {
+					auto in = data;
+					(void)read_size( in );
+					for( std::size_t n = 0; n < size; ++n ) {
+						if( n % block_size == 0 ) {
+							result.push_back( in.data( ) );
+						}
+						skip_impl1<element_t>( in );
+					}
+					result.push_back( in.data( ) );
+				}
+				return result;
+			}
+		} // namespace burp_impl
+
+		/// @brief Decode an encoded vector like container on several threads.  The result is sized
+		/// up front and each thread decodes blocks of elements in place, stealing blocks from the
+		/// others when it runs out.  Element boundaries come from the offset table of an
+		/// indexed_container or from a fixed element size, other containers are scanned once
+		/// without decoding to find them.  The result is the same as read<Container>( data ).
+		template<typename Container>
+		[[nodiscard]] Container parallel_read( burp_impl::encoded_span data,
+		                                       parallel_read_options const &options = { } ) {
+			using element_t = burp_impl::container_element_t<Container>;
+			static_assert( concepts::is_container_v<Container> and
+			                 concepts::container_detect::is_resizable_container_v<Container> and
+			                 std::is_same_v<element_t, typename Container::value_type> and
+			                 std::is_default_constructible_v<element_t>,
+			               "parallel_read requires a resizable container of default constructible "
+			               "elements" );
+
+			auto in = data;
+			auto const size = burp_impl::read_size( in );
+			daw_burp_ensure( size <= data.size( ), daw::burp::ErrorReason::InputError );
+			auto thread_count = options.thread_count;
+			if( thread_count == 0 ) {
+				thread_count = std::thread::hardware_concurrency( );
+				thread_count = thread_count == 0 ? 1 : thread_count;
+			}
+			auto block_size = options.block_size;
+			if( block_size == 0 ) {
+				auto const blocks = thread_count * burp_impl::parallel_read_blocks_per_thread;
+				block_size = ( size + blocks - 1U ) / blocks;
+				block_size = block_size == 0 ? 1 : block_size;
+			}
+			auto const bounds = burp_impl::parallel_block_bounds<Container>( data, size, block_size );
+			auto const block_count = bounds.size( ) - 1U;
+			thread_count = thread_count < block_count ? thread_count : block_count;
+
+			auto result = Container( );
+			result.resize( size );
+			if( size == 0 ) {
+				return result;
+			}
+			auto const decode_block = [&]( std::size_t block ) {
+				auto block_in = burp_impl::encoded_span(
+				  bounds[block], static_cast<std::size_t>( bounds[block + 1U] - bounds[block] ) );
+				auto const first = block * block_size;
+				auto const last = first + block_size < size ? first + block_size : size;
+				for( auto n = first; n < last; ++n ) {
+					burp_impl::read_into_impl1( block_in, result[n], burp_impl::default_allocator_t{ } );
+				}
+				daw_burp_ensure( block_in.empty( ), daw::burp::ErrorReason::InputError );
+			};
+			if( thread_count <= 1 ) {
+				for( std::size_t block = 0; block < block_count; ++block ) {
+					decode_block( block );
+				}
+				return result;
+			}
+
+			auto queues = std::make_unique<burp_impl::parallel_block_queue[]>( thread_count );
+			for( std::size_t t = 0; t < thread_count; ++t ) {
+				queues[t].assign( block_count * t / thread_count, block_count * ( t + 1U ) / thread_count );
+			}
+			auto has_error = std::atomic<bool>( false );
+			auto error_mutex = std::mutex( );
+			auto error = std::exception_ptr( );
+			auto const worker = [&]( std::size_t id ) {
+				try {
+					std::size_t block = 0;
+					while( not has_error.load( std::memory_order_relaxed ) ) {
+						if( queues[id].pop( block ) ) {
+							decode_block( block );
+							continue;
+						}
+						bool has_stolen = false;
+						for( std::size_t n = 1; n < thread_count and not has_stolen; ++n ) {
+							has_stolen = queues[id].steal_from( queues[( id + n ) % thread_count] );
+						}
+						if( not has_stolen ) {
+							break;
+						}
+					}
+				} catch( ... ) {
+					auto const lck = std::lock_guard<std::mutex>( error_mutex );
+					if( not error ) {
+						error = std::current_exception( );
+					}
+					has_error = true;
+				}
+			};
+			auto threads = std::vector<std::thread>( );
+			threads.reserve( thread_count - 1U );
+			for( std::size_t t = 1; t < thread_count; ++t ) {
+				threads.emplace_back( worker, t );
+			}
+			worker( 0 );
+			for( auto &t : threads ) {
+				t.join( );
+			}
+			if( error ) {
+				std::rethrow_exception( error );
+			}
+			return result;
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
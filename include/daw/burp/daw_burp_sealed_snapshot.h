@@ -0,0 +1,193 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/sigpipe.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+
+#if defined( __linux__ ) and defined( DAW_HAS_UNISTD ) and __has_include( <sys/sendfile.h> )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#if defined( MFD_ALLOW_SEALING ) and defined( F_ADD_SEALS )
+#define DAW_BURP_HAS_SEALED_SNAPSHOT
+#endif
+#endif
+
+#if defined( DAW_BURP_HAS_SEALED_SNAPSHOT )
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief A value serialized once into a sealed memfd.  The seals make the contents
+		/// immutable, so the descriptor can be handed to other processes to map, and sending it to a
+		/// socket or pipe with sendfile moves the pages in the kernel without copying them through
+		/// userspace again.
+		class sealed_snapshot {
+			int m_fd = -1;
+			std::size_t m_size = 0;
+
+			sealed_snapshot( int fd, std::size_t size ) noexcept
+			  : m_fd( fd )
+			  , m_size( size ) {}
+
+		public:
+			/// @brief Serialize value into a new sealed memfd
+			template<typename T>
+			[[nodiscard]] static sealed_snapshot create( T const &value ) {
+				// Sized first as it can throw, and nothing owns the descriptor yet
+				auto const size = daw::burp::calc_size( value );
+				int const fd = ::memfd_create( "daw_burp_snapshot", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+				daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::OutputError );
+				auto result = sealed_snapshot( fd, size );
+				daw_burp_ensure( ::ftruncate( fd, static_cast<off_t>( result.m_size ) ) == 0,
+				                 daw::burp::ErrorReason::OutputError );
+				if( result.m_size > 0 ) {
+					void *const mapping =
+					  ::mmap( nullptr, result.m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+					daw_burp_ensure( mapping != MAP_FAILED, daw::burp::ErrorReason::OutputError );
+					char *out = static_cast<char *>( mapping );
+					try {
+						burp_impl::visit_impl1(
+						  [&]( auto const &...blobs ) {
+							  concepts::writable_output_trait<char *>::write( out, blobs... );
+						  },
+						  value );
+					} catch( ... ) {
+						::munmap( mapping, result.m_size );
+						throw;
+					}
+					// The write seal cannot be added while a writable mapping exists
+					::munmap( mapping, result.m_size );
+				}
+				auto const seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL;
+				daw_burp_ensure( ::fcntl( fd, F_ADD_SEALS, seals ) == 0,
+				                 daw::burp::ErrorReason::OutputError );
+				return result;
+			}
+
+			sealed_snapshot( sealed_snapshot &&other ) noexcept
+			  : m_fd( std::exchange( other.m_fd, -1 ) )
+			  , m_size( std::exchange( other.m_size, 0 ) ) {}
+
+			sealed_snapshot &operator=( sealed_snapshot &&rhs ) noexcept {
+				std::swap( m_fd, rhs.m_fd );
+				std::swap( m_size, rhs.m_size );
+				return *this;
+			}
+
+			sealed_snapshot( sealed_snapshot const & ) = delete;
+			sealed_snapshot &operator=( sealed_snapshot const & ) = delete;
+
+			~sealed_snapshot( ) {
+				if( m_fd >= 0 ) {
+					::close( m_fd );
+				}
+			}
+
+			/// @brief The memfd, for passing to processes that map the snapshot themselves
+			[[nodiscard]] int fd( ) const noexcept {
+				return m_fd;
+			}
+
+			/// @brief Size of the serialized value
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			/// @brief Send the bytes from offset on to out until they are all sent or out would block.
+			/// Returns the new offset, which is size( ) when done.  A reader that has gone is an
+			/// OutputError, sendfile has no MSG_NOSIGNAL so SIGPIPE is blocked around it
+			std::size_t send_some( concepts::fd_t out, std::size_t offset ) const {
+				auto const no_sigpipe = burp_impl::sigpipe_blocker( );
+				while( offset < m_size ) {
+					auto pos = static_cast<off_t>( offset );
+					auto const ret = ::sendfile( out.value, m_fd, &pos, m_size - offset );
+					if( ret < 0 ) {
+						if( errno == EINTR ) {
+							continue;
+						}
+						daw_burp_ensure( errno == EAGAIN or errno == EWOULDBLOCK,
+						                 daw::burp::ErrorReason::OutputError );
+						break;
+					}
+					daw_burp_ensure( ret > 0, daw::burp::ErrorReason::OutputError );
+					offset += static_cast<std::size_t>( ret );
+				}
+				return offset;
+			}
+
+			/// @brief Send the whole snapshot to a blocking socket, pipe or file
+			void send_to( concepts::fd_t out ) const {
+				auto const offset = send_some( out, 0 );
+				daw_burp_ensure( offset == m_size, daw::burp::ErrorReason::OutputError );
+			}
+		};
+
+		/// @brief A read only mapping of a sealed_snapshot, possibly created by another process
+		class snapshot_mapping {
+			void const *m_data = nullptr;
+			std::size_t m_size = 0;
+
+		public:
+			/// @brief Map the snapshot in fd, which need not stay open
+			explicit snapshot_mapping( int fd ) {
+				auto const seals = ::fcntl( fd, F_GET_SEALS );
+				daw_burp_ensure( seals >= 0 and ( seals & F_SEAL_WRITE ) != 0 and
+				                   ( seals & F_SEAL_SHRINK ) != 0,
+				                 daw::burp::ErrorReason::InputError );
+				// fstat leaves the file offset, which may be shared with other processes, alone
+				struct ::stat st{ };
+				daw_burp_ensure( ::fstat( fd, &st ) == 0, daw::burp::ErrorReason::InputError );
+				m_size = static_cast<std::size_t>( st.st_size );
+				if( m_size > 0 ) {
+					m_data = ::mmap( nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0 );
+					daw_burp_ensure( m_data != MAP_FAILED, daw::burp::ErrorReason::InputError );
+				}
+			}
+
+			explicit snapshot_mapping( sealed_snapshot const &snapshot )
+			  : snapshot_mapping( snapshot.fd( ) ) {}
+
+			snapshot_mapping( snapshot_mapping &&other ) noexcept
+			  : m_data( std::exchange( other.m_data, nullptr ) )
+			  , m_size( std::exchange( other.m_size, 0 ) ) {}
+
+			snapshot_mapping &operator=( snapshot_mapping &&rhs ) noexcept {
+				std::swap( m_data, rhs.m_data );
+				std::swap( m_size, rhs.m_size );
+				return *this;
+			}
+
+			snapshot_mapping( snapshot_mapping const & ) = delete;
+			snapshot_mapping &operator=( snapshot_mapping const & ) = delete;
+
+			~snapshot_mapping( ) {
+				if( m_data ) {
+					::munmap( const_cast<void *>( m_data ), m_size );
+				}
+			}
+
+			/// @brief The serialized bytes, for read or view
+			[[nodiscard]] daw::span<char const> data( ) const noexcept {
+				return daw::span<char const>( static_cast<char const *>( m_data ), m_size );
+			}
+		};
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
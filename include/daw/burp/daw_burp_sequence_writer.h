@@ -0,0 +1,194 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_readable_input.h"
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+#include <daw/daw_traits.h>
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <type_traits>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief Writes a sequence of T to a writable output one element at a time, without the
+		/// sequence existing in memory.  On a seekable output the encoding is the same as that of
+		/// a container of T, with the count written as a placeholder and patched on close.  Other
+		/// outputs get a chunked framing where the elements are buffered up to chunk_size bytes and
+		/// written with their count, see read_sequence and element_range.
+		template<typename T, typename Writable>
+		class sequence_writer {
+			using out_t = concepts::writable_output_trait<Writable>;
+			static_assert( out_t::value, "Writable must be a writable output" );
+
+			static auto get_position( Writable &out ) {
+				if constexpr( concepts::is_seekable_writable_output_v<Writable> ) {
+					return out_t::position( out );
+				} else {
+					return std::optional<std::nullptr_t>{ };
+				}
+			}
+
+			using position_t = decltype( get_position( std::declval<Writable &>( ) ) );
+
+			Writable *m_out;
+			position_t m_count_position;
+			std::string m_chunk{ };
+			std::size_t m_chunk_size;
+			std::size_t m_count = 0;
+			std::size_t m_chunk_count = 0;
+			bool m_is_open = true;
+
+			void write_size( std::size_t sz ) {
+				auto const *ptr = reinterpret_cast<char const *>( &sz );
+				out_t::write( *m_out, daw::span<char const>( ptr, sizeof( sz ) ) );
+			}
+
+			void flush_chunk( ) {
+				if( m_chunk_count == 0 ) {
+					return;
+				}
+				write_size( m_chunk_count );
+				out_t::write( *m_out, daw::span<char const>( m_chunk.data( ), m_chunk.size( ) ) );
+				m_chunk.clear( );
+				m_chunk_count = 0;
+			}
+
+		public:
+			static constexpr std::size_t default_chunk_size = 64ULL * 1024ULL;
+
+			explicit sequence_writer( Writable &out, std::size_t chunk_size = default_chunk_size )
+			  : m_out( &out )
+			  , m_count_position( get_position( out ) )
+			  , m_chunk_size( chunk_size ) {
+				write_size( m_count_position ? 0 : burp_impl::chunked_sequence_marker );
+			}
+
+			sequence_writer( sequence_writer const & ) = delete;
+			sequence_writer &operator=( sequence_writer const & ) = delete;
+
+			~sequence_writer( ) {
+				if( m_is_open ) {
+					try {
+						close( );
+					} catch( ... ) {}
+				}
+			}
+
+			/// @brief Is the chunked framing being used because the output cannot seek
+			[[nodiscard]] bool is_chunked( ) const noexcept {
+				return not m_count_position.has_value( );
+			}
+
+			/// @brief Number of elements written so far
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return m_count;
+			}
+
+			void push_back( T const &value ) {
+				daw_burp_ensure( m_is_open, daw::burp::ErrorReason::OutputError );
+				if( m_count_position ) {
+					(void)daw::burp::write( *m_out, value );
+				} else {
+					(void)daw::burp::write( m_chunk, value );
+					++m_chunk_count;
+					if( m_chunk.size( ) >= m_chunk_size ) {
+						flush_chunk( );
+					}
+				}
+				++m_count;
+			}
+
+			/// @brief Finish the sequence by patching in its count, or by writing the last chunk and the
+			/// terminating empty chunk.  Called by the destructor if needed
+			void close( ) {
+				if( not m_is_open ) {
+					return;
+				}
+				m_is_open = false;
+				if constexpr( concepts::is_seekable_writable_output_v<Writable> ) {
+					if( m_count_position ) {
+						out_t::patch( *m_out,
+						              *m_count_position,
+						              reinterpret_cast<char const *>( &m_count ),
+						              sizeof( m_count ) );
+						return;
+					}
+				}
+				flush_chunk( );
+				write_size( 0 );
+			}
+		};
+
+		/// @brief Start writing a sequence of T to writable
+		template<typename T, typename Writable>
+		[[nodiscard]] sequence_writer<T, Writable> make_sequence_writer(
+		  Writable &writable,
+		  std::size_t chunk_size = sequence_writer<T, Writable>::default_chunk_size ) {
+			return sequence_writer<T, Writable>( writable, chunk_size );
+		}
+
+		/// @brief Write the elements of [first, last) as a sequence, visiting each once.  For input
+		/// iterators and generators whose length is not known up front.  Returns the element count
+		template<typename Writable, typename Iterator, typename Sentinel>
+		std::size_t write_range( Writable &writable, Iterator first, Sentinel last ) {
+			using element_t = daw::remove_cvref_t<decltype( *first )>;
+			auto seq = make_sequence_writer<element_t>( writable );
+			for( ; first != last; ++first ) {
+				seq.push_back( *first );
+			}
+			seq.close( );
+			return seq.size( );
+		}
+
+		/// @brief Write the elements of range as a sequence, visiting each once.  Returns the element
+		/// count
+		template<typename Writable, typename Range>
+		std::size_t write_range( Writable &writable, Range &&range ) {
+			return write_range( writable, std::begin( range ), std::end( range ) );
+		}
+
+		/// @brief Deserialize a Container written by a sequence_writer, with either framing
+		template<typename Container, typename Readable>
+		[[nodiscard]] Container read_sequence( Readable &&readable ) {
+			using in_t = daw::remove_cvref_t<Readable>;
+			static_assert( concepts::is_readable_input_type_v<in_t> );
+			static_assert( not std::is_const_v<std::remove_reference_t<Readable>> );
+			using element_t = burp_impl::read_value_type_t<burp_impl::container_element_t<Container>>;
+			auto const alloc = burp_impl::default_allocator_t{ };
+			auto sz = burp_impl::read_size( readable );
+			bool const is_chunked = sz == burp_impl::chunked_sequence_marker;
+			if( is_chunked ) {
+				sz = burp_impl::read_size( readable );
+			}
+			auto result = Container( );
+			while( sz > 0 ) {
+				auto const reserve = burp_impl::checked_element_count<element_t>( readable, sz );
+				if constexpr( concepts::container_detect::is_reservable_container_v<Container> ) {
+					result.reserve( std::size( result ) + reserve );
+				}
+				for( std::size_t n = 0; n < sz; ++n ) {
+					result.insert( std::end( result ),
+					               burp_impl::read_impl1<element_t>( readable, alloc ) );
+				}
+				sz = is_chunked ? burp_impl::read_size( readable ) : 0;
+			}
+			return result;
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
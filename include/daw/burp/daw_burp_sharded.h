@@ -0,0 +1,315 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+#include "daw_burp_snapshot_store.h"
+
+#include <daw/daw_span.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined( DAW_BURP_HAS_SNAPSHOT_STORE )
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief One file of a sharded container, holding the elements [first, first + count)
+		struct shard_info {
+			std::string path;
+			std::uint64_t first;
+			std::uint64_t count;
+			std::uint64_t size;
+		};
+
+		/// @brief Describes where the elements of a container written by write_sharded are
+		struct shard_manifest {
+			std::uint64_t element_count;
+			std::vector<shard_info> shards;
+		};
+
+		template<>
+		struct generic_dto<shard_info> {
+			static DAW_CONSTEVAL std::size_t member_count( ) {
+				return 4;
+			}
+
+			template<typename Value>
+			static constexpr auto to_tuple( Value &value ) noexcept {
+				return std::forward_as_tuple( value.path, value.first, value.count, value.size );
+			}
+		};
+
+		template<>
+		struct generic_dto<shard_manifest> {
+			static DAW_CONSTEVAL std::size_t member_count( ) {
+				return 2;
+			}
+
+			template<typename Value>
+			static constexpr auto to_tuple( Value &value ) noexcept {
+				return std::forward_as_tuple( value.element_count, value.shards );
+			}
+		};
+
+		/// @brief The default sink of write_sharded.  Writes a file through a buffer so that small
+		/// blobs do not each cost a system call, and syncs it in finish.  A sink is constructed from
+		/// the path of its shard, is a writable output and has a finish( ) member called after the
+		/// shard is written.
+		class file_shard_sink {
+			int m_fd = -1;
+			std::string m_buffer{ };
+
+			void write_fd( char const *data, std::size_t size ) {
+				while( size > 0 ) {
+					auto const ret = ::write( m_fd, data, size );
+					if( ret < 0 and errno == EINTR ) {
+						continue;
+					}
+					daw_burp_ensure( ret > 0, daw::burp::ErrorReason::OutputError );
+					data += ret;
+					size -= static_cast<std::size_t>( ret );
+				}
+			}
+
+		public:
+			static constexpr std::size_t buffer_size = 1024ULL * 1024ULL;
+
+			explicit file_shard_sink( std::string const &path )
+			  : m_fd( ::open( path.c_str( ), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 ) ) {
+				daw_burp_ensure( m_fd >= 0, daw::burp::ErrorReason::OutputError );
+				m_buffer.reserve( buffer_size );
+			}
+
+			file_shard_sink( file_shard_sink const & ) = delete;
+			file_shard_sink &operator=( file_shard_sink const & ) = delete;
+
+			~file_shard_sink( ) {
+				if( m_fd >= 0 ) {
+					::close( m_fd );
+				}
+			}
+
+			template<typename... ContiguousBytes>
+			void write( ContiguousBytes const &...blobs ) {
+				auto const write_blob = [&]( auto const &blob ) {
+					auto const *data = reinterpret_cast<char const *>( std::data( blob ) );
+					auto const size = std::size( blob );
+					if( m_buffer.size( ) + size > buffer_size ) {
+						write_fd( m_buffer.data( ), m_buffer.size( ) );
+						m_buffer.clear( );
+						if( size >= buffer_size ) {
+							write_fd( data, size );
+							return 0;
+						}
+					}
+					m_buffer.append( data, size );
+					return 0;
+				};
+				(void)( write_blob( blobs ) | ... );
+			}
+
+			/// @brief Write what is buffered and wait for it to reach the device
+			void finish( ) {
+				write_fd( m_buffer.data( ), m_buffer.size( ) );
+				m_buffer.clear( );
+				daw_burp_ensure( ::fsync( m_fd ) == 0 and ::close( std::exchange( m_fd, -1 ) ) == 0,
+				                 daw::burp::ErrorReason::OutputError );
+			}
+		};
+
+		namespace concepts {
+			/// @brief Specialization for file_shard_sink
+			template<>
+			struct writable_output_trait<file_shard_sink> : std::true_type {
+				static constexpr std::size_t capacity( file_shard_sink const & ) noexcept {
+					return std::numeric_limits<std::size_t>::max( );
+				}
+
+				template<typename... ContiguousBytes>
+				static inline void write( file_shard_sink &out, ContiguousBytes... blobs ) {
+					static_assert( sizeof...( ContiguousBytes ) > 0 );
+					out.write( blobs... );
+				}
+
+				static inline void put( file_shard_sink &out, char c ) {
+					out.write( daw::span<char const>( &c, 1 ) );
+				}
+			};
+		} // namespace concepts
+
+		namespace burp_impl {
+			/// Run func( n ) for each n in [0, count) on its own thread, the calling thread taking the
+			/// first.  The first exception thrown is rethrown once all have finished
+			template<typename Function>
+			void run_per_shard( std::size_t count, Function const &func ) {
+				auto error_mutex = std::mutex( );
+				auto error = std::exception_ptr( );
+				auto const run = [&]( std::size_t n ) {
+					try {
+						func( n );
+					} catch( ... ) {
+						auto const lck = std::lock_guard<std::mutex>( error_mutex );
+						if( not error ) {
+							error = std::current_exception( );
+						}
+					}
+				};
+				auto threads = std::vector<std::thread>( );
+				threads.reserve( count );
+				for( std::size_t n = 1; n < count; ++n ) {
+					threads.emplace_back( run, n );
+				}
+				if( count > 0 ) {
+					run( 0 );
+				}
+				for( auto &t : threads ) {
+					t.join( );
+				}
+				if( error ) {
+					std::rethrow_exception( error );
+				}
+			}
+
+			/// A read only mapping of a shard file
+			class mapped_shard {
+				void const *m_data = nullptr;
+				std::size_t m_size = 0;
+
+			public:
+				explicit mapped_shard( std::string const &path ) {
+					int const fd = ::open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+					daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::InputError );
+					struct ::stat st{ };
+					bool const has_size = ::fstat( fd, &st ) == 0;
+					m_size = has_size ? static_cast<std::size_t>( st.st_size ) : 0;
+					if( m_size > 0 ) {
+						m_data = ::mmap( nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0 );
+					}
+					::close( fd );
+					daw_burp_ensure( has_size and m_data != MAP_FAILED, daw::burp::ErrorReason::InputError );
+				}
+
+				mapped_shard( mapped_shard const & ) = delete;
+				mapped_shard &operator=( mapped_shard const & ) = delete;
+
+				~mapped_shard( ) {
+					if( m_data ) {
+						::munmap( const_cast<void *>( m_data ), m_size );
+					}
+				}
+
+				[[nodiscard]] encoded_span data( ) const noexcept {
+					return encoded_span( static_cast<char const *>( m_data ), m_size );
+				}
+			};
+		} // namespace burp_impl
+
+		/// @brief Write the elements of value split into contiguous ranges, one per path, on a
+		/// thread each, so that files on separate devices are written in parallel.  Each shard is
+		/// encoded like a container of its elements.  A manifest of the shards is saved with
+		/// save_snapshot to manifest_path once they are all written, read_sharded uses it to put
+		/// the container back together.
+		template<typename Sink = file_shard_sink, typename Container>
+		shard_manifest write_sharded( Container const &value,
+		                              std::vector<std::string> const &paths,
+		                              std::string const &manifest_path ) {
+			static_assert( concepts::is_writable_output_type_v<Sink> );
+			static_assert( concepts::is_container_v<Container> );
+			daw_burp_ensure( not paths.empty( ), daw::burp::ErrorReason::OutputError );
+			auto const element_count = concepts::container_size( value );
+			auto const shard_count = paths.size( );
+
+			using iterator_t = decltype( std::begin( value ) );
+			auto bounds = std::vector<iterator_t>( );
+			bounds.reserve( shard_count + 1U );
+			auto manifest = shard_manifest{ element_count, { } };
+			auto it = std::begin( value );
+			std::size_t first = 0;
+			for( std::size_t n = 0; n < shard_count; ++n ) {
+				auto const last = element_count * ( n + 1U ) / shard_count;
+				bounds.push_back( it );
+				manifest.shards.push_back( shard_info{ paths[n], first, last - first, 0 } );
+				it = std::next( it, static_cast<std::ptrdiff_t>( last - first ) );
+				first = last;
+			}
+			bounds.push_back( it );
+
+			burp_impl::run_per_shard( shard_count, [&]( std::size_t n ) {
+				auto sink = Sink( paths[n] );
+				manifest.shards[n].size =
+				  daw::burp::write( sink, iterator_range( bounds[n], bounds[n + 1U] ) );
+				sink.finish( );
+			} );
+			(void)save_snapshot( manifest_path, manifest );
+			return manifest;
+		}
+
+		/// @brief Read a container written by write_sharded.  The result is sized up front and the
+		/// shards are mapped and decoded into it in parallel, a thread per shard
+		template<typename Container>
+		[[nodiscard]] Container read_sharded( shard_manifest const &manifest ) {
+			using element_t = burp_impl::container_element_t<Container>;
+			static_assert( concepts::is_container_v<Container> and
+			                 concepts::container_detect::is_resizable_container_v<Container> and
+			                 std::is_same_v<element_t, typename Container::value_type> and
+			                 std::is_default_constructible_v<element_t>,
+			               "read_sharded requires a resizable container of default constructible "
+			               "elements" );
+			std::uint64_t expected_first = 0;
+			for( auto const &shard : manifest.shards ) {
+				daw_burp_ensure( shard.first == expected_first and
+				                   shard.count <= manifest.element_count - shard.first,
+				                 daw::burp::ErrorReason::InputError );
+				expected_first += shard.count;
+			}
+			daw_burp_ensure( expected_first == manifest.element_count,
+			                 daw::burp::ErrorReason::InputError );
+
+			auto result = Container( );
+			result.resize( static_cast<std::size_t>( manifest.element_count ) );
+			burp_impl::run_per_shard( manifest.shards.size( ), [&]( std::size_t n ) {
+				auto const &shard = manifest.shards[n];
+				auto const file = burp_impl::mapped_shard( shard.path );
+				auto in = file.data( );
+				daw_burp_ensure( in.size( ) == shard.size and burp_impl::read_size( in ) == shard.count,
+				                 daw::burp::ErrorReason::InputError );
+				auto const first = static_cast<std::size_t>( shard.first );
+				for( std::size_t i = 0; i < shard.count; ++i ) {
+					burp_impl::read_into_impl1( in, result[first + i], burp_impl::default_allocator_t{ } );
+				}
+				daw_burp_ensure( in.empty( ), daw::burp::ErrorReason::InputError );
+			} );
+			return result;
+		}
+
+		/// @brief Read a container written by write_sharded, given the path of its manifest
+		template<typename Container>
+		[[nodiscard]] Container read_sharded( std::string const &manifest_path ) {
+			auto const snapshot = load_snapshot( manifest_path );
+			snapshot.verify( );
+			return read_sharded<Container>( snapshot.read<shard_manifest>( ) );
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
@@ -0,0 +1,536 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#if defined( DAW_HAS_UNISTD ) and __has_include( <sys/mman.h> )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define DAW_BURP_HAS_SHM_RING
+#if defined( __linux__ )
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#define DAW_BURP_HAS_FUTEX
+#endif
+#endif
+
+#if defined( DAW_BURP_HAS_SHM_RING )
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			static_assert( std::atomic<std::uint64_t>::is_always_lock_free and
+			                 std::atomic<std::uint32_t>::is_always_lock_free,
+			               "Shared memory rings need address free atomics" );
+			static_assert( sizeof( std::atomic<std::uint32_t> ) == sizeof( std::uint32_t ) );
+
+			inline constexpr std::uint64_t shm_ring_magic = 0x4255'5250'5249'4E47ULL;
+			inline constexpr std::uint64_t shm_ring_abandoned =
+			  std::numeric_limits<std::uint64_t>::max( );
+
+			/// At the start of the mapping, the slots follow it.  The producer and consumer positions
+			/// are on their own cache lines
+			struct shm_ring_header {
+				std::uint64_t magic;
+				std::uint64_t slot_count;
+				std::uint64_t slot_size;
+				alignas( 64 ) std::atomic<std::uint64_t> enqueue_pos;
+				alignas( 64 ) std::atomic<std::uint64_t> dequeue_pos;
+				// Bumped after each commit/release, waiters sleep on them
+				alignas( 64 ) std::atomic<std::uint32_t> committed;
+				std::atomic<std::uint32_t> consumer_waiters;
+				alignas( 64 ) std::atomic<std::uint32_t> released;
+				std::atomic<std::uint32_t> producer_waiters;
+			};
+
+			/// Each slot is a sequence number and size followed by the message.  A slot at position pos
+			/// is free when sequence == pos, holds a message when sequence == pos + 1 and is handed
+			/// back for the next lap by storing pos + slot_count
+			struct shm_ring_slot_header {
+				std::atomic<std::uint64_t> sequence;
+				std::uint64_t size;
+			};
+
+			inline constexpr std::size_t shm_ring_header_size =
+			  ( sizeof( shm_ring_header ) + 63U ) & ~std::size_t{ 63U };
+
+			/// Sleep while word is still expected.  Spurious returns are fine as callers loop
+			inline void shm_ring_wait( std::atomic<std::uint32_t> &word, std::uint32_t expected ) {
+#if defined( DAW_BURP_HAS_FUTEX )
+				(void)::syscall( SYS_futex,
+				                 reinterpret_cast<std::uint32_t *>( &word ),
+				                 FUTEX_WAIT,
+				                 expected,
+				                 nullptr,
+				                 nullptr,
+				                 0 );
+#else
+				if( word.load( ) == expected ) {
+					std::this_thread::yield( );
+				}
+#endif
+			}
+
+			inline void shm_ring_wake( std::atomic<std::uint32_t> &word ) {
+#if defined( DAW_BURP_HAS_FUTEX )
+				(void)::syscall( SYS_futex,
+				                 reinterpret_cast<std::uint32_t *>( &word ),
+				                 FUTEX_WAKE,
+				                 std::numeric_limits<int>::max( ),
+				                 nullptr,
+				                 nullptr,
+				                 0 );
+#else
+				(void)word;
+#endif
+			}
+
+			inline void shm_ring_commit( shm_ring_header &header,
+			                             shm_ring_slot_header &slot,
+			                             std::uint64_t pos,
+			                             std::uint64_t size ) {
+				slot.size = size;
+				slot.sequence.store( pos + 1U, std::memory_order_release );
+				header.committed.fetch_add( 1U );
+				if( header.consumer_waiters.load( ) > 0 ) {
+					shm_ring_wake( header.committed );
+				}
+			}
+
+			inline void shm_ring_release( shm_ring_header &header,
+			                              shm_ring_slot_header &slot,
+			                              std::uint64_t pos ) {
+				slot.sequence.store( pos + header.slot_count, std::memory_order_release );
+				header.released.fetch_add( 1U );
+				if( header.producer_waiters.load( ) > 0 ) {
+					shm_ring_wake( header.released );
+				}
+			}
+		} // namespace burp_impl
+
+		/// @brief A reserved slot of a shm_ring that a message is serialized directly into.  The
+		/// message is visible to consumers after commit( ).  A slot that is destroyed without being
+		/// committed is skipped by consumers.
+		class shm_ring_slot {
+			burp_impl::shm_ring_header *m_header;
+			burp_impl::shm_ring_slot_header *m_slot;
+			char *m_data;
+			std::uint64_t m_pos;
+			std::size_t m_capacity;
+			std::size_t m_size = 0;
+			bool m_is_open = true;
+
+			void publish( std::uint64_t size ) {
+				m_is_open = false;
+				burp_impl::shm_ring_commit( *m_header, *m_slot, m_pos, size );
+			}
+
+		public:
+			shm_ring_slot( burp_impl::shm_ring_header &header,
+			               burp_impl::shm_ring_slot_header &slot,
+			               std::uint64_t pos ) noexcept
+			  : m_header( &header )
+			  , m_slot( &slot )
+			  , m_data( reinterpret_cast<char *>( &slot ) + sizeof( burp_impl::shm_ring_slot_header ) )
+			  , m_pos( pos )
+			  , m_capacity( header.slot_size - sizeof( burp_impl::shm_ring_slot_header ) ) {}
+
+			shm_ring_slot( shm_ring_slot &&other ) noexcept
+			  : m_header( other.m_header )
+			  , m_slot( other.m_slot )
+			  , m_data( other.m_data )
+			  , m_pos( other.m_pos )
+			  , m_capacity( other.m_capacity )
+			  , m_size( other.m_size )
+			  , m_is_open( std::exchange( other.m_is_open, false ) ) {}
+
+			shm_ring_slot( shm_ring_slot const & ) = delete;
+			shm_ring_slot &operator=( shm_ring_slot const & ) = delete;
+			shm_ring_slot &operator=( shm_ring_slot && ) = delete;
+
+			~shm_ring_slot( ) {
+				if( m_is_open ) {
+					publish( burp_impl::shm_ring_abandoned );
+				}
+			}
+
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			[[nodiscard]] std::size_t capacity( ) const noexcept {
+				return m_capacity;
+			}
+
+			void append( char const *ptr, std::size_t count ) {
+				daw_burp_ensure( m_is_open and count <= m_capacity - m_size,
+				                 daw::burp::ErrorReason::OutputError );
+				std::memcpy( m_data + m_size, ptr, count );
+				m_size += count;
+			}
+
+			/// @brief Publish the message to consumers
+			void commit( ) {
+				daw_burp_ensure( m_is_open, daw::burp::ErrorReason::OutputError );
+				publish( m_size );
+			}
+		};
+
+		/// @brief A committed message of a shm_ring.  The bytes are read in place and the slot is
+		/// handed back to producers when the message is released or destroyed
+		class shm_ring_message {
+			burp_impl::shm_ring_header *m_header;
+			burp_impl::shm_ring_slot_header *m_slot;
+			std::uint64_t m_pos;
+			bool m_is_open = true;
+
+		public:
+			shm_ring_message( burp_impl::shm_ring_header &header,
+			                  burp_impl::shm_ring_slot_header &slot,
+			                  std::uint64_t pos ) noexcept
+			  : m_header( &header )
+			  , m_slot( &slot )
+			  , m_pos( pos ) {}
+
+			shm_ring_message( shm_ring_message &&other ) noexcept
+			  : m_header( other.m_header )
+			  , m_slot( other.m_slot )
+			  , m_pos( other.m_pos )
+			  , m_is_open( std::exchange( other.m_is_open, false ) ) {}
+
+			shm_ring_message( shm_ring_message const & ) = delete;
+			shm_ring_message &operator=( shm_ring_message const & ) = delete;
+			shm_ring_message &operator=( shm_ring_message && ) = delete;
+
+			~shm_ring_message( ) {
+				release( );
+			}
+
+			/// @brief The serialized message, valid until release
+			[[nodiscard]] daw::span<char const> data( ) const noexcept {
+				return daw::span<char const>(
+				  reinterpret_cast<char const *>( m_slot ) + sizeof( burp_impl::shm_ring_slot_header ),
+				  static_cast<std::size_t>( m_slot->size ) );
+			}
+
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return static_cast<std::size_t>( m_slot->size );
+			}
+
+			/// @brief Hand the slot back to the producers
+			void release( ) noexcept {
+				if( m_is_open ) {
+					m_is_open = false;
+					burp_impl::shm_ring_release( *m_header, *m_slot, m_pos );
+				}
+			}
+		};
+
+		/// @brief A bounded queue of messages in shared memory for passing burp messages between
+		/// processes.  Producers serialize directly into a reserved slot and consumers read the
+		/// committed bytes in place, so a message is written once and never copied.  Any number of
+		/// producers and consumers can use the ring concurrently, from any process that maps it.
+		/// Blocking calls sleep on a futex where available.
+		class shm_ring {
+			int m_fd = -1;
+			void *m_mapping = nullptr;
+			std::size_t m_mapping_size = 0;
+
+			shm_ring( int fd, void *mapping, std::size_t mapping_size ) noexcept
+			  : m_fd( fd )
+			  , m_mapping( mapping )
+			  , m_mapping_size( mapping_size ) {}
+
+			[[nodiscard]] burp_impl::shm_ring_header &header( ) const noexcept {
+				return *static_cast<burp_impl::shm_ring_header *>( m_mapping );
+			}
+
+			[[nodiscard]] burp_impl::shm_ring_slot_header &slot_at( std::uint64_t pos ) const noexcept {
+				auto const &h = header( );
+				auto const index = static_cast<std::size_t>( pos & ( h.slot_count - 1U ) );
+				return *reinterpret_cast<burp_impl::shm_ring_slot_header *>(
+				  static_cast<char *>( m_mapping ) + burp_impl::shm_ring_header_size +
+				  index * static_cast<std::size_t>( h.slot_size ) );
+			}
+
+			static void *map_fd( int fd, std::size_t size ) {
+				void *const mapping = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+				if( mapping == MAP_FAILED ) {
+					::close( fd );
+				}
+				daw_burp_ensure( mapping != MAP_FAILED, daw::burp::ErrorReason::InputError );
+				return mapping;
+			}
+
+			/// Size the file, map it and lay out an empty ring
+			static shm_ring initialize( int fd, std::size_t slot_count, std::size_t max_message_size ) {
+				daw_burp_ensure( slot_count > 0 and ( slot_count & ( slot_count - 1U ) ) == 0,
+				                 daw::burp::ErrorReason::OutputError );
+				auto const slot_size =
+				  ( sizeof( burp_impl::shm_ring_slot_header ) + max_message_size + 63U ) &
+				  ~std::size_t{ 63U };
+				auto const mapping_size = burp_impl::shm_ring_header_size + slot_count * slot_size;
+				bool const is_sized = ::ftruncate( fd, static_cast<off_t>( mapping_size ) ) == 0;
+				if( not is_sized ) {
+					::close( fd );
+				}
+				daw_burp_ensure( is_sized, daw::burp::ErrorReason::OutputError );
+				auto result = shm_ring( fd, map_fd( fd, mapping_size ), mapping_size );
+				auto *const h = new( result.m_mapping ) burp_impl::shm_ring_header{ };
+				h->slot_count = slot_count;
+				h->slot_size = slot_size;
+				for( std::size_t n = 0; n < slot_count; ++n ) {
+					auto *const slot = new( &result.slot_at( n ) ) burp_impl::shm_ring_slot_header{ };
+					slot->sequence.store( n, std::memory_order_relaxed );
+				}
+				std::atomic_thread_fence( std::memory_order_release );
+				h->magic = burp_impl::shm_ring_magic;
+				return result;
+			}
+
+		public:
+			/// @brief Create a new ring in POSIX shared memory that other processes can open by name.
+			/// slot_count must be a power of two and each message can be up to max_message_size bytes
+			[[nodiscard]] static shm_ring create( std::string const &name,
+			                                      std::size_t slot_count,
+			                                      std::size_t max_message_size ) {
+				int const fd = ::shm_open( name.c_str( ), O_CREAT | O_EXCL | O_RDWR, 0600 );
+				daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::OutputError );
+				return initialize( fd, slot_count, max_message_size );
+			}
+
+#if defined( MFD_CLOEXEC )
+			/// @brief Create a new ring in an anonymous memfd.  Other processes map it with from_fd
+			/// after inheriting the descriptor or receiving it over a unix socket
+			[[nodiscard]] static shm_ring create_anonymous( std::size_t slot_count,
+			                                                std::size_t max_message_size ) {
+				int const fd = ::memfd_create( "daw_burp_shm_ring", MFD_CLOEXEC );
+				daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::OutputError );
+				return initialize( fd, slot_count, max_message_size );
+			}
+#endif
+
+			/// @brief Map a ring created by another shm_ring.  Takes ownership of fd
+			[[nodiscard]] static shm_ring from_fd( int fd ) {
+				daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::InputError );
+				struct ::stat st{ };
+				bool const has_header =
+				  ::fstat( fd, &st ) == 0 and
+				  static_cast<std::size_t>( st.st_size ) >= burp_impl::shm_ring_header_size;
+				if( not has_header ) {
+					::close( fd );
+				}
+				daw_burp_ensure( has_header, daw::burp::ErrorReason::InputError );
+				auto const mapping_size = static_cast<std::size_t>( st.st_size );
+				auto result = shm_ring( fd, map_fd( fd, mapping_size ), mapping_size );
+				auto const &h = result.header( );
+				// Positions are mapped to slots with a mask and slot headers are atomics, so the same
+				// limits as initialize apply to a ring made by someone else
+				daw_burp_ensure( h.magic == burp_impl::shm_ring_magic and h.slot_count > 0 and
+				                   ( h.slot_count & ( h.slot_count - 1U ) ) == 0 and
+				                   h.slot_size > sizeof( burp_impl::shm_ring_slot_header ) and
+				                   h.slot_size % alignof( burp_impl::shm_ring_slot_header ) == 0 and
+				                   ( mapping_size - burp_impl::shm_ring_header_size ) / h.slot_count >=
+				                     h.slot_size,
+				                 daw::burp::ErrorReason::InputError );
+				std::atomic_thread_fence( std::memory_order_acquire );
+				return result;
+			}
+
+			/// @brief Open a ring created by name with create
+			[[nodiscard]] static shm_ring open( std::string const &name ) {
+				return from_fd( ::shm_open( name.c_str( ), O_RDWR, 0600 ) );
+			}
+
+			/// @brief Remove the name of a ring, existing mappings stay valid
+			static void unlink( std::string const &name ) noexcept {
+				(void)::shm_unlink( name.c_str( ) );
+			}
+
+			shm_ring( shm_ring &&other ) noexcept
+			  : m_fd( std::exchange( other.m_fd, -1 ) )
+			  , m_mapping( std::exchange( other.m_mapping, nullptr ) )
+			  , m_mapping_size( std::exchange( other.m_mapping_size, 0 ) ) {}
+
+			shm_ring &operator=( shm_ring &&rhs ) noexcept {
+				std::swap( m_fd, rhs.m_fd );
+				std::swap( m_mapping, rhs.m_mapping );
+				std::swap( m_mapping_size, rhs.m_mapping_size );
+				return *this;
+			}
+
+			shm_ring( shm_ring const & ) = delete;
+			shm_ring &operator=( shm_ring const & ) = delete;
+
+			~shm_ring( ) {
+				if( m_mapping ) {
+					::munmap( m_mapping, m_mapping_size );
+				}
+				if( m_fd >= 0 ) {
+					::close( m_fd );
+				}
+			}
+
+			/// @brief The descriptor of the shared memory, for passing to another process
+			[[nodiscard]] int fd( ) const noexcept {
+				return m_fd;
+			}
+
+			[[nodiscard]] std::size_t slot_count( ) const noexcept {
+				return static_cast<std::size_t>( header( ).slot_count );
+			}
+
+			[[nodiscard]] std::size_t max_message_size( ) const noexcept {
+				return static_cast<std::size_t>( header( ).slot_size ) -
+				       sizeof( burp_impl::shm_ring_slot_header );
+			}
+
+			/// @brief Reserve the next slot, or nothing when the ring is full
+			[[nodiscard]] std::optional<shm_ring_slot> try_reserve( ) {
+				auto &h = header( );
+				auto pos = h.enqueue_pos.load( std::memory_order_relaxed );
+				while( true ) {
+					auto &slot = slot_at( pos );
+					auto const seq = slot.sequence.load( std::memory_order_acquire );
+					auto const diff = static_cast<std::int64_t>( seq - pos );
+					if( diff == 0 ) {
+						if( h.enqueue_pos.compare_exchange_weak( pos, pos + 1U, std::memory_order_relaxed ) ) {
+							return shm_ring_slot( h, slot, pos );
+						}
+					} else if( diff < 0 ) {
+						return std::nullopt;
+					} else {
+						pos = h.enqueue_pos.load( std::memory_order_relaxed );
+					}
+				}
+			}
+
+			/// @brief Reserve the next slot, waiting for a consumer to release one when full
+			[[nodiscard]] shm_ring_slot reserve( ) {
+				auto &h = header( );
+				while( true ) {
+					auto const released = h.released.load( );
+					if( auto slot = try_reserve( ) ) {
+						return std::move( *slot );
+					}
+					h.producer_waiters.fetch_add( 1U );
+					burp_impl::shm_ring_wait( h.released, released );
+					h.producer_waiters.fetch_sub( 1U );
+				}
+			}
+
+			/// @brief Take the next committed message, or nothing when the ring is empty
+			[[nodiscard]] std::optional<shm_ring_message> try_pop( ) {
+				auto &h = header( );
+				auto pos = h.dequeue_pos.load( std::memory_order_relaxed );
+				while( true ) {
+					auto &slot = slot_at( pos );
+					auto const seq = slot.sequence.load( std::memory_order_acquire );
+					auto const diff = static_cast<std::int64_t>( seq - ( pos + 1U ) );
+					if( diff == 0 ) {
+						if( h.dequeue_pos.compare_exchange_weak( pos, pos + 1U, std::memory_order_relaxed ) ) {
+							if( slot.size != burp_impl::shm_ring_abandoned ) {
+								return shm_ring_message( h, slot, pos );
+							}
+							burp_impl::shm_ring_release( h, slot, pos );
+							pos = h.dequeue_pos.load( std::memory_order_relaxed );
+						}
+					} else if( diff < 0 ) {
+						return std::nullopt;
+					} else {
+						pos = h.dequeue_pos.load( std::memory_order_relaxed );
+					}
+				}
+			}
+
+			/// @brief Take the next committed message, waiting for a producer when empty
+			[[nodiscard]] shm_ring_message pop( ) {
+				auto &h = header( );
+				while( true ) {
+					auto const committed = h.committed.load( );
+					if( auto message = try_pop( ) ) {
+						return std::move( *message );
+					}
+					h.consumer_waiters.fetch_add( 1U );
+					burp_impl::shm_ring_wait( h.committed, committed );
+					h.consumer_waiters.fetch_sub( 1U );
+				}
+			}
+
+			/// @brief Serialize value into the next slot and commit it, waiting when the ring is full.
+			/// Returns the message size
+			template<typename T>
+			std::size_t push( T const &value ) {
+				auto slot = reserve( );
+				auto const result = daw::burp::write( slot, value );
+				slot.commit( );
+				return result;
+			}
+
+			/// @brief Serialize value into the next slot and commit it.  Returns false when the ring is
+			/// full
+			template<typename T>
+			[[nodiscard]] bool try_push( T const &value ) {
+				auto slot = try_reserve( );
+				if( not slot ) {
+					return false;
+				}
+				(void)daw::burp::write( *slot, value );
+				slot->commit( );
+				return true;
+			}
+		};
+
+		namespace concepts {
+			/// @brief Specialization for writing into a reserved shm_ring slot
+			template<>
+			struct writable_output_trait<shm_ring_slot> : std::true_type {
+				static inline std::size_t capacity( shm_ring_slot const &out ) noexcept {
+					return out.capacity( ) - out.size( );
+				}
+
+				template<typename... ContiguousBytes>
+				static inline void write( shm_ring_slot &out, ContiguousBytes... blobs ) {
+					static_assert( sizeof...( ContiguousBytes ) > 0 );
+					constexpr auto writer = []( shm_ring_slot &o, auto sv ) {
+						if( sv.empty( ) ) {
+							return 0;
+						}
+						o.append( reinterpret_cast<char const *>( std::data( sv ) ), std::size( sv ) );
+						return 0;
+					};
+					(void)( writer( out, blobs ) | ... );
+				}
+
+				static inline void put( shm_ring_slot &out, char c ) {
+					out.append( &c, 1 );
+				}
+			};
+		} // namespace concepts
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
@@ -0,0 +1,146 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp_buffer_pool.h"
+
+#include <daw/daw_span.h>
+
+#include <cstddef>
+#include <cstring>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief A writable output that keeps up to InlineCapacity bytes inside the object and only
+		/// goes to the heap when a message is larger.  The heap block comes from the thread's
+		/// buffer_pool and is kept across clear( ) so that a buffer reused for many messages allocates
+		/// at most a few times.
+		template<std::size_t InlineCapacity>
+		class small_output_buffer {
+			static_assert( InlineCapacity > 0 );
+			char m_inline[InlineCapacity];
+			pooled_block m_heap{ };
+			std::size_t m_size = 0;
+			bool m_is_inline = true;
+
+			void spill( std::size_t new_capacity ) {
+				if( new_capacity > m_heap.capacity( ) ) {
+					auto next = thread_local_buffer_pool( ).acquire( new_capacity );
+					if( m_size > 0 ) {
+						std::memcpy( next.data( ), data( ), m_size );
+					}
+					m_heap = std::move( next );
+				} else if( m_is_inline and m_size > 0 ) {
+					std::memcpy( m_heap.data( ), m_inline, m_size );
+				}
+				m_is_inline = false;
+			}
+
+		public:
+			using value_type = char;
+			static constexpr std::size_t inline_capacity = InlineCapacity;
+
+			small_output_buffer( ) = default;
+
+			[[nodiscard]] char *data( ) noexcept {
+				return m_is_inline ? m_inline : m_heap.data( );
+			}
+
+			[[nodiscard]] char const *data( ) const noexcept {
+				return m_is_inline ? m_inline : m_heap.data( );
+			}
+
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			[[nodiscard]] bool empty( ) const noexcept {
+				return m_size == 0;
+			}
+
+			[[nodiscard]] std::size_t capacity( ) const noexcept {
+				return m_is_inline ? InlineCapacity : m_heap.capacity( );
+			}
+
+			/// @brief Are the contents stored inside the object
+			[[nodiscard]] bool is_inline( ) const noexcept {
+				return m_is_inline;
+			}
+
+			/// @brief The serialized bytes
+			[[nodiscard]] daw::span<char const> span( ) const noexcept {
+				return daw::span<char const>( data( ), m_size );
+			}
+
+			/// @brief Ensure that at least new_capacity bytes can be written without allocating.  Use
+			/// with calc_size to size the buffer once before writing
+			void reserve( std::size_t new_capacity ) {
+				if( new_capacity > capacity( ) ) {
+					spill( new_capacity );
+				}
+			}
+
+			void append( char const *ptr, std::size_t count ) {
+				if( m_size + count > capacity( ) ) {
+					auto const grown = capacity( ) * 2U;
+					spill( grown > m_size + count ? grown : m_size + count );
+				}
+				std::memcpy( data( ) + m_size, ptr, count );
+				m_size += count;
+			}
+
+			void push_back( char c ) {
+				append( &c, 1 );
+			}
+
+			/// @brief Empty the buffer, subsequent writes go inline again but any heap block is retained
+			/// for the next message that needs it
+			void clear( ) noexcept {
+				m_size = 0;
+				m_is_inline = true;
+			}
+		};
+
+		namespace concepts {
+			/// @brief Specialization for small_output_buffer
+			template<std::size_t InlineCapacity>
+			struct writable_output_trait<small_output_buffer<InlineCapacity>> : std::true_type {
+				using buffer_t = small_output_buffer<InlineCapacity>;
+
+				static constexpr std::size_t capacity( buffer_t const & ) noexcept {
+					return std::numeric_limits<std::size_t>::max( );
+				}
+
+				static inline void reserve( buffer_t &out, std::size_t additional ) {
+					out.reserve( out.size( ) + additional );
+				}
+
+				template<typename... ContiguousBytes>
+				static inline void write( buffer_t &out, ContiguousBytes... blobs ) {
+					static_assert( sizeof...( ContiguousBytes ) > 0 );
+					constexpr auto writer = []( buffer_t &o, auto sv ) {
+						if( sv.empty( ) ) {
+							return 0;
+						}
+						o.append( reinterpret_cast<char const *>( std::data( sv ) ), std::size( sv ) );
+						return 0;
+					};
+					(void)( writer( out, blobs ) | ... );
+				}
+
+				static inline void put( buffer_t &out, char c ) {
+					out.push_back( c );
+				}
+			};
+		} // namespace concepts
+	}   // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,252 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/crc32c.h"
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+#include "daw_burp.h"
+#include "daw_burp_view.h"
+
+#include <daw/daw_span.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#if defined( DAW_HAS_UNISTD ) and __has_include( <sys/mman.h> )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define DAW_BURP_HAS_SNAPSHOT_STORE
+#endif
+
+#if defined( DAW_BURP_HAS_SNAPSHOT_STORE )
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			/// Precedes the encoded value in a snapshot file.  The payload follows directly and is
+			/// 64 byte aligned in the mapping, so aligned_container's keep their alignment
+			struct snapshot_file_header {
+				std::uint64_t magic;
+				std::uint32_t layout_version;
+				std::uint32_t format_version;
+				std::uint64_t payload_size;
+				std::uint32_t payload_crc;
+				std::uint32_t reserved[9];
+			};
+			static_assert( sizeof( snapshot_file_header ) == 64 );
+
+			inline constexpr std::uint64_t snapshot_file_magic = 0x5041'4E53'5052'5542ULL; // BURPSNAP
+			inline constexpr std::uint32_t snapshot_file_layout_version = 1;
+
+			/// The directory part of path, for syncing the rename
+			inline std::string snapshot_directory( std::string const &path ) {
+				auto const pos = path.find_last_of( '/' );
+				if( pos == std::string::npos ) {
+					return ".";
+				}
+				return pos == 0 ? std::string( "/" ) : path.substr( 0, pos );
+			}
+
+			/// Serialize value after a header into fd, which is already open and empty.  Returns the
+			/// payload size
+			template<typename T>
+			std::size_t write_snapshot_file( int fd, T const &value, std::uint32_t format_version ) {
+				auto const payload_size = daw::burp::calc_size( value );
+				auto const file_size = sizeof( snapshot_file_header ) + payload_size;
+				daw_burp_ensure( ::ftruncate( fd, static_cast<off_t>( file_size ) ) == 0,
+				                 daw::burp::ErrorReason::OutputError );
+				void *const mapping =
+				  ::mmap( nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+				daw_burp_ensure( mapping != MAP_FAILED, daw::burp::ErrorReason::OutputError );
+				char *out = static_cast<char *>( mapping ) + sizeof( snapshot_file_header );
+				std::uint32_t crc = 0;
+				try {
+					burp_impl::visit_impl1(
+					  [&]( auto const &...blobs ) {
+						  ( ( crc = crc32c( crc, std::data( blobs ), std::size( blobs ) ) ), ... );
+						  concepts::writable_output_trait<char *>::write( out, blobs... );
+					  },
+					  value );
+				} catch( ... ) {
+					::munmap( mapping, file_size );
+					throw;
+				}
+				auto const header = snapshot_file_header{ snapshot_file_magic,
+				                                          snapshot_file_layout_version,
+				                                          format_version,
+				                                          payload_size,
+				                                          crc,
+				                                          { } };
+				std::memcpy( mapping, &header, sizeof( header ) );
+				::munmap( mapping, file_size );
+				daw_burp_ensure( ::fsync( fd ) == 0, daw::burp::ErrorReason::OutputError );
+				return payload_size;
+			}
+
+			/// Create a new file beside path for save_snapshot to write and store its name in tmp_path.
+			/// The name has the process id and a counter so that saves running at the same time, in
+			/// this process or another, each get their own
+			inline int create_snapshot_temp( std::string const &path, std::string &tmp_path ) {
+				static auto counter = std::atomic<std::uint64_t>( 0 );
+				while( true ) {
+					tmp_path = path + ".tmp." + std::to_string( ::getpid( ) ) + "." +
+					           std::to_string( counter.fetch_add( 1U, std::memory_order_relaxed ) );
+					int const fd =
+					  ::open( tmp_path.c_str( ), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644 );
+					// A leftover from a crashed process that had the same id is skipped
+					if( fd >= 0 or errno != EEXIST ) {
+						return fd;
+					}
+				}
+			}
+		} // namespace burp_impl
+
+		/// @brief Atomically replace the snapshot at path with value.  The snapshot is written to a
+		/// temporary file beside path and synced before being renamed over it, so a crash leaves
+		/// either the old or the new snapshot.  format_version is stored in the header for the
+		/// caller to check on load.  Returns the payload size.
+		template<typename T>
+		std::size_t save_snapshot( std::string const &path,
+		                           T const &value,
+		                           std::uint32_t format_version = 0 ) {
+			auto tmp_path = std::string( );
+			int const fd = burp_impl::create_snapshot_temp( path, tmp_path );
+			daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::OutputError );
+			std::size_t payload_size = 0;
+			try {
+				payload_size = burp_impl::write_snapshot_file( fd, value, format_version );
+			} catch( ... ) {
+				::close( fd );
+				::unlink( tmp_path.c_str( ) );
+				throw;
+			}
+			bool const is_renamed =
+			  ::close( fd ) == 0 and std::rename( tmp_path.c_str( ), path.c_str( ) ) == 0;
+			if( not is_renamed ) {
+				::unlink( tmp_path.c_str( ) );
+			}
+			daw_burp_ensure( is_renamed, daw::burp::ErrorReason::OutputError );
+			// The rename is only durable once the directory entry is synced
+			int const dir_fd =
+			  ::open( burp_impl::snapshot_directory( path ).c_str( ), O_RDONLY | O_CLOEXEC );
+			if( dir_fd >= 0 ) {
+				(void)::fsync( dir_fd );
+				::close( dir_fd );
+			}
+			return payload_size;
+		}
+
+		/// @brief A read only mapping of a snapshot file.  Nothing is decoded when it is loaded, pages
+		/// are read as the view_as results touch them
+		class snapshot_file {
+			void const *m_mapping = nullptr;
+			std::size_t m_mapping_size = 0;
+			burp_impl::snapshot_file_header m_header{ };
+
+		public:
+			/// @brief Map the snapshot at path and check its header
+			explicit snapshot_file( std::string const &path ) {
+				int const fd = ::open( path.c_str( ), O_RDONLY | O_CLOEXEC );
+				daw_burp_ensure( fd >= 0, daw::burp::ErrorReason::InputError );
+				struct ::stat st{ };
+				if( ::fstat( fd, &st ) == 0 and
+				    static_cast<std::size_t>( st.st_size ) >= sizeof( m_header ) ) {
+					m_mapping_size = static_cast<std::size_t>( st.st_size );
+					m_mapping = ::mmap( nullptr, m_mapping_size, PROT_READ, MAP_SHARED, fd, 0 );
+				}
+				// The mapping stays valid after the descriptor is closed
+				::close( fd );
+				daw_burp_ensure( m_mapping_size > 0 and m_mapping != MAP_FAILED,
+				                 daw::burp::ErrorReason::InputError );
+				std::memcpy( &m_header, m_mapping, sizeof( m_header ) );
+				if( m_header.magic != burp_impl::snapshot_file_magic or
+				    m_header.layout_version != burp_impl::snapshot_file_layout_version or
+				    m_header.payload_size != m_mapping_size - sizeof( m_header ) ) {
+					::munmap( const_cast<void *>( m_mapping ), m_mapping_size );
+					m_mapping = nullptr;
+				}
+				daw_burp_ensure( m_mapping != nullptr, daw::burp::ErrorReason::InputError );
+			}
+
+			snapshot_file( snapshot_file &&other ) noexcept
+			  : m_mapping( std::exchange( other.m_mapping, nullptr ) )
+			  , m_mapping_size( std::exchange( other.m_mapping_size, 0 ) )
+			  , m_header( other.m_header ) {}
+
+			snapshot_file &operator=( snapshot_file &&rhs ) noexcept {
+				std::swap( m_mapping, rhs.m_mapping );
+				std::swap( m_mapping_size, rhs.m_mapping_size );
+				std::swap( m_header, rhs.m_header );
+				return *this;
+			}
+
+			snapshot_file( snapshot_file const & ) = delete;
+			snapshot_file &operator=( snapshot_file const & ) = delete;
+
+			~snapshot_file( ) {
+				if( m_mapping ) {
+					::munmap( const_cast<void *>( m_mapping ), m_mapping_size );
+				}
+			}
+
+			/// @brief The format_version passed to save_snapshot
+			[[nodiscard]] std::uint32_t format_version( ) const noexcept {
+				return m_header.format_version;
+			}
+
+			/// @brief The encoded value
+			[[nodiscard]] daw::span<char const> data( ) const noexcept {
+				return daw::span<char const>(
+				  static_cast<char const *>( m_mapping ) + sizeof( m_header ),
+				  static_cast<std::size_t>( m_header.payload_size ) );
+			}
+
+			/// @brief Check the payload against the CRC32C in the header, throws ChecksumError on a
+			/// mismatch.  This reads the whole file
+			void verify( ) const {
+				auto const payload = data( );
+				daw_burp_ensure( crc32c( 0, payload.data( ), payload.size( ) ) == m_header.payload_crc,
+				                 daw::burp::ErrorReason::ChecksumError );
+			}
+
+			/// @brief Ask the kernel to start reading the file in the background
+			void prefetch( ) const noexcept {
+				(void)::madvise( const_cast<void *>( m_mapping ), m_mapping_size, MADV_WILLNEED );
+			}
+
+			/// @brief Decode the whole value
+			template<typename T>
+			[[nodiscard]] T read( ) const {
+				return daw::burp::read<T>( data( ) );
+			}
+
+			/// @brief A lazy view of the value, view<T> for mapped classes and container_view for
+			/// containers, that decodes only what is accessed
+			template<typename T>
+			[[nodiscard]] auto view_as( ) const {
+				return burp_impl::make_lazy<T>( data( ) );
+			}
+		};
+
+		/// @brief Map the snapshot at path without decoding it
+		[[nodiscard]] inline snapshot_file load_snapshot( std::string const &path ) {
+			return snapshot_file( path );
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
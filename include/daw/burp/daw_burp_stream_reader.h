@@ -0,0 +1,379 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_readable_input.h"
+#include "daw_burp.h"
+
+#include <daw/daw_traits.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined( DAW_HAS_UNISTD )
+#include <fcntl.h>
+#endif
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		/// @brief A readable input that pulls from a file descriptor, FILE * or istream through a
+		/// fixed size buffer.  Memory use is bounded by the buffer regardless of the size of the
+		/// stream, and requests larger than the buffer are read directly into their destination.
+		class buffered_reader {
+			using source_fn_t = std::size_t ( * )( void *, char *, std::size_t );
+
+			void *m_source;
+			source_fn_t m_source_read;
+			std::unique_ptr<char[]> m_buffer;
+			std::size_t m_capacity;
+			std::size_t m_first = 0;
+			std::size_t m_last = 0;
+			int m_fd = -1;
+
+			static std::size_t read_file( void *source, char *dest, std::size_t count ) {
+				auto *f = static_cast<std::FILE *>( source );
+				auto const ret = std::fread( dest, 1, count, f );
+				daw_burp_ensure( ret == count or not std::ferror( f ), daw::burp::ErrorReason::InputError );
+				return ret;
+			}
+
+			static std::size_t read_istream( void *source, char *dest, std::size_t count ) {
+				auto &is = *static_cast<std::istream *>( source );
+				is.read( dest, static_cast<std::streamsize>( count ) );
+				daw_burp_ensure( not is.bad( ), daw::burp::ErrorReason::InputError );
+				return static_cast<std::size_t>( is.gcount( ) );
+			}
+
+#if defined( DAW_HAS_UNISTD )
+			static std::size_t read_fd( void *source, char *dest, std::size_t count ) {
+				auto const fd = *static_cast<int *>( source );
+				while( true ) {
+					auto const ret = ::read( fd, dest, count );
+					if( ret >= 0 ) {
+						return static_cast<std::size_t>( ret );
+					}
+					daw_burp_ensure( errno == EINTR, daw::burp::ErrorReason::InputError );
+				}
+			}
+#endif
+
+			/// Read until count bytes are available or the source is exhausted
+			std::size_t read_source( char *dest, std::size_t count ) {
+				std::size_t result = 0;
+				while( result < count ) {
+					auto const ret = m_source_read( m_source, dest + result, count - result );
+					if( ret == 0 ) {
+						break;
+					}
+					result += ret;
+				}
+				return result;
+			}
+
+			void refill( ) {
+				m_first = 0;
+				m_last = read_source( m_buffer.get( ), m_capacity );
+#if defined( DAW_HAS_UNISTD ) and defined( POSIX_FADV_WILLNEED )
+				if( m_fd >= 0 and m_last == m_capacity ) {
+					// Ask for the next buffer's worth while this one is being decoded.  Fails harmlessly
+					// on pipes and sockets
+					auto const pos = ::lseek( m_fd, 0, SEEK_CUR );
+					if( pos >= 0 ) {
+						(void)::posix_fadvise(
+						  m_fd, pos, static_cast<off_t>( m_capacity ), POSIX_FADV_WILLNEED );
+					}
+				}
+#endif
+			}
+
+			buffered_reader( void *source, source_fn_t source_read, std::size_t buffer_size )
+			  : m_source( source )
+			  , m_source_read( source_read )
+			  , m_buffer( std::make_unique<char[]>( buffer_size > 0 ? buffer_size : 1 ) )
+			  , m_capacity( buffer_size > 0 ? buffer_size : 1 ) {}
+
+		public:
+			static constexpr std::size_t default_buffer_size = 64ULL * 1024ULL;
+
+			explicit buffered_reader( std::FILE *f, std::size_t buffer_size = default_buffer_size )
+			  : buffered_reader( f, &read_file, buffer_size ) {}
+
+			explicit buffered_reader( std::istream &is,
+			                          std::size_t buffer_size = default_buffer_size )
+			  : buffered_reader( &is, &read_istream, buffer_size ) {}
+
+#if defined( DAW_HAS_UNISTD )
+			explicit buffered_reader( concepts::fd_t fd, std::size_t buffer_size = default_buffer_size )
+			  : buffered_reader( nullptr, &read_fd, buffer_size ) {
+				m_fd = fd.value;
+				m_source = &m_fd;
+#if defined( POSIX_FADV_SEQUENTIAL )
+				(void)::posix_fadvise( m_fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+#endif
+			}
+#endif
+
+			// m_source can point into the reader
+			buffered_reader( buffered_reader const & ) = delete;
+			buffered_reader &operator=( buffered_reader const & ) = delete;
+
+			[[nodiscard]] std::size_t buffer_size( ) const noexcept {
+				return m_capacity;
+			}
+
+			/// @brief Number of bytes read from the source but not consumed
+			[[nodiscard]] std::size_t buffered( ) const noexcept {
+				return m_last - m_first;
+			}
+
+			void read( char *dest, std::size_t count ) {
+				auto const available = buffered( );
+				if( count <= available ) {
+					std::memcpy( dest, m_buffer.get( ) + m_first, count );
+					m_first += count;
+					return;
+				}
+				if( available > 0 ) {
+					std::memcpy( dest, m_buffer.get( ) + m_first, available );
+					dest += available;
+					count -= available;
+				}
+				m_first = m_last = 0;
+				if( count >= m_capacity ) {
+					auto const ret = read_source( dest, count );
+					daw_burp_ensure( ret == count, daw::burp::ErrorReason::InputError );
+					return;
+				}
+				refill( );
+				daw_burp_ensure( count <= m_last, daw::burp::ErrorReason::InputError );
+				std::memcpy( dest, m_buffer.get( ), count );
+				m_first = count;
+			}
+
+			void skip( std::size_t count ) {
+				while( count > 0 ) {
+					if( m_first == m_last ) {
+						refill( );
+						daw_burp_ensure( m_last > 0, daw::burp::ErrorReason::InputError );
+					}
+					auto const step = count < buffered( ) ? count : buffered( );
+					m_first += step;
+					count -= step;
+				}
+			}
+
+			[[nodiscard]] bool at_end( ) {
+				if( m_first == m_last ) {
+					refill( );
+				}
+				return m_first == m_last;
+			}
+		};
+
+		namespace concepts {
+			/// @brief Specialization for buffered_reader
+			template<>
+			struct readable_input_trait<buffered_reader> : std::true_type {
+				static inline void read( buffered_reader &in, char *dest, std::size_t count ) {
+					in.read( dest, count );
+				}
+
+				static inline void skip( buffered_reader &in, std::size_t count ) {
+					in.skip( count );
+				}
+
+				static inline bool at_end( buffered_reader &in ) {
+					return in.at_end( );
+				}
+			};
+		} // namespace concepts
+
+		namespace burp_impl {
+			enum class record_framing { until_end, counted, chunked };
+
+			/// Shared iteration state of record_range and element_range.  The current value is decoded
+			/// into the same object each step so its memory is reused
+			template<typename T, typename Readable>
+			class record_cursor {
+				Readable *m_in;
+				T m_value{ };
+				std::size_t m_remaining;
+				record_framing m_framing;
+				bool m_has_value = false;
+
+			public:
+				explicit record_cursor( Readable &in,
+				                        record_framing framing,
+				                        std::size_t remaining = 0 ) noexcept
+				  : m_in( &in )
+				  , m_remaining( remaining )
+				  , m_framing( framing ) {}
+
+				[[nodiscard]] bool has_value( ) const noexcept {
+					return m_has_value;
+				}
+
+				[[nodiscard]] T const &value( ) const noexcept {
+					return m_value;
+				}
+
+				void next( ) {
+					m_has_value = false;
+					switch( m_framing ) {
+					case record_framing::until_end:
+						if constexpr( concepts::has_readable_input_at_end_v<Readable> ) {
+							if( concepts::readable_input_trait<Readable>::at_end( *m_in ) ) {
+								return;
+							}
+						}
+						break;
+					case record_framing::chunked:
+						if( m_remaining == 0 ) {
+							// A zero length chunk ends the sequence
+							m_remaining = read_size( *m_in );
+						}
+						[[fallthrough]];
+					case record_framing::counted:
+						if( m_remaining == 0 ) {
+							return;
+						}
+						--m_remaining;
+						break;
+					}
+					read_into( *m_in, m_value );
+					m_has_value = true;
+				}
+			};
+
+			template<typename T, typename Readable>
+			class record_iterator {
+				record_cursor<T, Readable> *m_cursor = nullptr;
+
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = T;
+				using reference = T const &;
+				using pointer = T const *;
+				using difference_type = std::ptrdiff_t;
+
+				record_iterator( ) = default;
+
+				explicit record_iterator( record_cursor<T, Readable> &cursor ) noexcept
+				  : m_cursor( cursor.has_value( ) ? &cursor : nullptr ) {}
+
+				[[nodiscard]] reference operator*( ) const noexcept {
+					return m_cursor->value( );
+				}
+
+				[[nodiscard]] pointer operator->( ) const noexcept {
+					return &m_cursor->value( );
+				}
+
+				record_iterator &operator++( ) {
+					m_cursor->next( );
+					if( not m_cursor->has_value( ) ) {
+						m_cursor = nullptr;
+					}
+					return *this;
+				}
+
+				void operator++( int ) {
+					operator++( );
+				}
+
+				[[nodiscard]] friend bool operator==( record_iterator const &lhs,
+				                                      record_iterator const &rhs ) noexcept {
+					return lhs.m_cursor == rhs.m_cursor;
+				}
+
+				[[nodiscard]] friend bool operator!=( record_iterator const &lhs,
+				                                      record_iterator const &rhs ) noexcept {
+					return lhs.m_cursor != rhs.m_cursor;
+				}
+			};
+
+			template<typename T, typename Readable>
+			class basic_record_range {
+				record_cursor<T, Readable> m_cursor;
+				bool m_started = false;
+
+			public:
+				using iterator = record_iterator<T, Readable>;
+
+				explicit basic_record_range( Readable &in,
+				                             record_framing framing,
+				                             std::size_t count = 0 )
+				  : m_cursor( in, framing, count ) {}
+
+				/// @brief Single pass, begin can only be called once
+				[[nodiscard]] iterator begin( ) {
+					if( not m_started ) {
+						m_started = true;
+						m_cursor.next( );
+					}
+					return iterator( m_cursor );
+				}
+
+				[[nodiscard]] iterator end( ) const noexcept {
+					return iterator( );
+				}
+			};
+		} // namespace burp_impl
+
+		/// @brief A single pass range over the records of T written back to back in readable, ending
+		/// when the input is exhausted.  The reference returned by the iterator is only valid until it
+		/// is incremented.
+		template<typename T, typename Readable>
+		[[nodiscard]] auto record_range( Readable &readable ) {
+			static_assert( concepts::is_readable_input_type_v<Readable> );
+			static_assert( concepts::has_readable_input_at_end_v<Readable>,
+			               "The end of the input must be detectable" );
+			return burp_impl::basic_record_range<T, Readable>( readable,
+			                                                   burp_impl::record_framing::until_end );
+		}
+
+		/// @brief A single pass range over the elements of an encoded Container in readable, decoding
+		/// one element at a time instead of materializing the container.  Sequences written in chunks
+		/// by a sequence_writer are supported too.  The reference returned by the iterator is only
+		/// valid until it is incremented.
+		template<typename Container, typename Readable>
+		[[nodiscard]] auto element_range( Readable &readable ) {
+			static_assert( concepts::is_readable_input_type_v<Readable> );
+			static_assert( concepts::is_container_v<Container> );
+			static_assert( not burp_impl::is_string_table_v<Container> and
+			                 not burp_impl::is_bool_vector_v<Container> and
+			                 not burp_impl::is_aligned_container_v<Container>,
+			               "The container is not encoded element by element" );
+			using element_t = burp_impl::read_value_type_t<burp_impl::container_element_t<Container>>;
+			using range_t = burp_impl::basic_record_range<element_t, Readable>;
+			auto const sz = burp_impl::read_size( readable );
+			if constexpr( burp_impl::is_indexed_container_v<Container> ) {
+				auto const width = burp_impl::read_index_width( readable );
+				daw_burp_ensure( sz <= burp_impl::dynamic_encoded_size / width,
+				                 daw::burp::ErrorReason::InputError );
+				burp_impl::skip_bytes( readable, sz * width );
+			} else {
+				if( sz == burp_impl::chunked_sequence_marker ) {
+					return range_t( readable, burp_impl::record_framing::chunked );
+				}
+			}
+			return range_t( readable, burp_impl::record_framing::counted, sz );
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,184 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/errors.h"
+#include "impl/version.h"
+
+#include "concepts/daw_writable_output.h"
+
+#include <daw/daw_span.h>
+#include <daw/daw_traits.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			/// Outputs where each write is a system call or takes a lock, these get their own buffer in
+			/// a tee_output
+			template<typename T>
+			inline constexpr bool is_stream_output_v =
+			  std::is_same_v<T, std::FILE *> or std::is_base_of_v<std::ostream, T>
+#if defined( DAW_HAS_UNISTD )
+			  or std::is_same_v<T, concepts::fd_t>
+#endif
+			  ;
+
+			/// One sink of a tee_output.  Stream outputs collect small blobs in a buffer of their own
+			/// and are written when it fills, other outputs are written to directly
+			template<typename Sink>
+			class tee_sink {
+				using out_t = concepts::writable_output_trait<Sink>;
+				static_assert( out_t::value, "Sinks must be writable outputs" );
+
+				Sink *m_sink;
+				std::string m_buffer{ };
+				std::size_t m_buffer_size;
+
+			public:
+				tee_sink( Sink &sink, std::size_t buffer_size ) noexcept
+				  : m_sink( &sink )
+				  , m_buffer_size( buffer_size ) {}
+
+				[[nodiscard]] std::size_t capacity( ) const {
+					return out_t::capacity( *m_sink );
+				}
+
+				void reserve( std::size_t size ) {
+					if constexpr( concepts::has_writable_output_reserve_v<Sink> ) {
+						out_t::reserve( *m_sink, size );
+					} else if constexpr( is_stream_output_v<Sink> ) {
+						m_buffer.reserve( size < m_buffer_size ? size : m_buffer_size );
+					}
+				}
+
+				template<typename... ContiguousBytes>
+				void write( ContiguousBytes const &...blobs ) {
+					if constexpr( is_stream_output_v<Sink> ) {
+						constexpr auto writer = []( tee_sink &s, auto const &blob ) {
+							auto const size = std::size( blob );
+							if( s.m_buffer.size( ) + size > s.m_buffer_size ) {
+								s.flush( );
+								if( size >= s.m_buffer_size ) {
+									// Large blobs go straight through instead of being copied
+									out_t::write( *s.m_sink, blob );
+									return 0;
+								}
+							}
+							s.m_buffer.append( reinterpret_cast<char const *>( std::data( blob ) ), size );
+							return 0;
+						};
+						(void)( writer( *this, blobs ) | ... );
+					} else {
+						out_t::write( *m_sink, blobs... );
+					}
+				}
+
+				void flush( ) {
+					if( not m_buffer.empty( ) ) {
+						out_t::write( *m_sink, daw::span<char const>( m_buffer.data( ), m_buffer.size( ) ) );
+						m_buffer.clear( );
+					}
+				}
+			};
+		} // namespace burp_impl
+
+		/// @brief A writable output that forwards everything written to it to each of its sinks, so
+		/// that a value is traversed once no matter how many places it is written to.  Stream sinks,
+		/// file descriptors, FILE * and ostreams, are buffered separately and bytes can remain in
+		/// their buffers until flush( ) or destruction.
+		template<typename... Sinks>
+		class tee_output {
+			static_assert( sizeof...( Sinks ) > 0 );
+			std::tuple<burp_impl::tee_sink<Sinks>...> m_sinks;
+
+		public:
+			static constexpr std::size_t default_buffer_size = 64ULL * 1024ULL;
+
+			explicit tee_output( Sinks &...sinks )
+			  : m_sinks( burp_impl::tee_sink<Sinks>( sinks, default_buffer_size )... ) {}
+
+			tee_output( std::size_t buffer_size, Sinks &...sinks )
+			  : m_sinks( burp_impl::tee_sink<Sinks>( sinks, buffer_size )... ) {}
+
+			tee_output( tee_output const & ) = delete;
+			tee_output &operator=( tee_output const & ) = delete;
+
+			~tee_output( ) {
+				try {
+					flush( );
+				} catch( ... ) {}
+			}
+
+			/// @brief The smallest capacity of the sinks
+			[[nodiscard]] std::size_t capacity( ) const {
+				return std::apply(
+				  []( auto const &...sinks ) {
+					  std::size_t result = std::numeric_limits<std::size_t>::max( );
+					  ( ( result = sinks.capacity( ) < result ? sinks.capacity( ) : result ), ... );
+					  return result;
+				  },
+				  m_sinks );
+			}
+
+			void reserve( std::size_t size ) {
+				std::apply( [&]( auto &...sinks ) { ( sinks.reserve( size ), ... ); }, m_sinks );
+			}
+
+			template<typename... ContiguousBytes>
+			void write( ContiguousBytes const &...blobs ) {
+				std::apply( [&]( auto &...sinks ) { ( sinks.write( blobs... ), ... ); }, m_sinks );
+			}
+
+			/// @brief Write out the buffered bytes of the stream sinks
+			void flush( ) {
+				std::apply( []( auto &...sinks ) { ( sinks.flush( ), ... ); }, m_sinks );
+			}
+		};
+
+		/// @brief Construct a tee_output writing to each of sinks
+		template<typename... Sinks>
+		[[nodiscard]] tee_output<Sinks...> make_tee_output( Sinks &...sinks ) {
+			return tee_output<Sinks...>( sinks... );
+		}
+
+		namespace concepts {
+			/// @brief Specialization for tee_output
+			template<typename... Sinks>
+			struct writable_output_trait<tee_output<Sinks...>> : std::true_type {
+				static inline std::size_t capacity( tee_output<Sinks...> const &out ) {
+					return out.capacity( );
+				}
+
+				static inline void reserve( tee_output<Sinks...> &out, std::size_t size ) {
+					out.reserve( size );
+				}
+
+				template<typename... ContiguousBytes>
+				static inline void write( tee_output<Sinks...> &out, ContiguousBytes... blobs ) {
+					static_assert( sizeof...( ContiguousBytes ) > 0 );
+					out.write( blobs... );
+				}
+
+				static inline void put( tee_output<Sinks...> &out, char c ) {
+					out.write( daw::span<char const>( &c, 1 ) );
+				}
+			};
+		} // namespace concepts
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
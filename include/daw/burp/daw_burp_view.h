@@ -0,0 +1,468 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "impl/version.h"
+
+#include "daw_burp.h"
+
+#include <daw/daw_span.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		template<typename T>
+		class view;
+
+		template<typename Container>
+		class container_view;
+
+		template<typename Container>
+		class string_table_view;
+
+		namespace burp_impl {
+			using encoded_span = daw::span<char const>;
+
+			/// Values with a fixed encoded size are cheap to decode and are returned by value.
+			/// Everything else is returned as a view over its encoding.
+			template<typename T>
+			auto make_lazy( encoded_span data ) {
+				if constexpr( fixed_encoded_size_v<T> != dynamic_encoded_size ) {
+					return read_impl1<T>( data, default_allocator_t{ } );
+				} else if constexpr( has_generic_dto_v<T> ) {
+					return view<T>( data );
+				} else if constexpr( is_string_table_v<T> ) {
+					return string_table_view<T>( data );
+				} else if constexpr( is_bool_vector_v<T> ) {
+					return read_impl1<T>( data, default_allocator_t{ } );
+				} else if constexpr( is_contiguous_array_of_fundamental_like_types_v<T> or
+				                     concepts::is_container_v<T> ) {
+					return container_view<T>( data );
+				} else {
+					return read_impl1<T>( data, default_allocator_t{ } );
+				}
+			}
+		} // namespace burp_impl
+
+		/// @brief A view of an encoded T that decodes members on access.  Members with a fixed
+		/// encoded size are found by a constant offset, variable sized members by skipping the
+		/// preceding ones.  Members are returned by value when they have a fixed encoded size and as a
+		/// view/container_view otherwise.
+		template<typename T>
+		class view {
+			static_assert( burp_impl::has_generic_dto_v<T>, "view requires a mapped class type" );
+			burp_impl::encoded_span m_data{ };
+
+			template<std::size_t Index>
+			burp_impl::encoded_span member_data( ) const {
+				// The members before Index are either all fixed size, or need to be skipped one by one
+				constexpr auto offset =
+				  burp_impl::fixed_dto_encoded_size<T>( std::make_index_sequence<Index>{ } );
+				auto result = m_data;
+				if constexpr( offset != burp_impl::dynamic_encoded_size ) {
+					concepts::readable_input_trait<burp_impl::encoded_span>::skip( result, offset );
+				} else {
+					burp_impl::skip_impl2<T>( result, std::make_index_sequence<Index>{ } );
+				}
+				return result;
+			}
+
+		public:
+			using value_type = T;
+
+			view( ) = default;
+
+			/// @param data A buffer that starts with an encoded T.  It may extend past the end of the T
+			explicit view( burp_impl::encoded_span data ) noexcept
+			  : m_data( data ) {}
+
+			/// @brief Access the member at Index in the generic_dto mapping of T
+			template<std::size_t Index>
+			[[nodiscard]] auto get( ) const {
+				static_assert( Index < generic_dto<T>::member_count( ) );
+				return burp_impl::make_lazy<burp_impl::dto_member_t<T, Index>>( member_data<Index>( ) );
+			}
+
+			/// @brief Decode the whole value
+			[[nodiscard]] T decode( ) const {
+				return read<T>( m_data );
+			}
+
+			/// @brief The number of bytes used by the encoding
+			[[nodiscard]] std::size_t encoded_size( ) const {
+				auto rest = m_data;
+				burp_impl::skip_impl1<T>( rest );
+				return m_data.size( ) - rest.size( );
+			}
+
+			[[nodiscard]] burp_impl::encoded_span data( ) const noexcept {
+				return m_data;
+			}
+		};
+
+		template<std::size_t Index, typename T>
+		[[nodiscard]] auto get( view<T> const &v ) {
+			return v.template get<Index>( );
+		}
+
+		/// @brief A range over an encoded container whose elements are decoded on dereference.  When
+		/// elements have a fixed encoded size, or the container is an indexed_container, operator[] is
+		/// constant time.
+		template<typename Container>
+		class container_view {
+			burp_impl::encoded_span m_data{ };
+
+			struct layout_t {
+				burp_impl::encoded_span index_table;
+				burp_impl::encoded_span elements;
+				std::size_t size;
+				std::size_t index_width;
+			};
+
+			layout_t layout( ) const {
+				auto in = m_data;
+				auto const sz = burp_impl::read_size( in );
+				if constexpr( burp_impl::is_indexed_container_v<Container> ) {
+					auto const width = burp_impl::read_index_width( in );
+					auto const table = in;
+					daw_burp_ensure( sz <= burp_impl::dynamic_encoded_size / width,
+					                 daw::burp::ErrorReason::InputError );
+					burp_impl::skip_bytes( in, sz * width );
+					return layout_t{ table, in, sz, width };
+				} else if constexpr( burp_impl::is_aligned_container_v<Container> ) {
+					burp_impl::skip_alignment_padding( in, Container::alignment );
+					return layout_t{ { }, in, sz, 0 };
+				} else {
+					return layout_t{ { }, in, sz, 0 };
+				}
+			}
+
+			static std::uint64_t index_entry( layout_t const &l, std::size_t index ) {
+				auto table = l.index_table;
+				burp_impl::skip_bytes( table, index * l.index_width );
+				return burp_impl::read_index_entry( table, l.index_width );
+			}
+
+		public:
+			using element_type = burp_impl::container_element_t<Container>;
+			using reference = decltype( burp_impl::make_lazy<element_type>( { } ) );
+			using size_type = std::size_t;
+
+			static constexpr std::size_t element_encoded_size =
+			  burp_impl::fixed_encoded_size_v<element_type>;
+
+			static constexpr bool has_random_access =
+			  burp_impl::is_indexed_container_v<Container> or
+			  element_encoded_size != burp_impl::dynamic_encoded_size;
+
+			class const_iterator {
+				burp_impl::encoded_span m_pos{ };
+				std::size_t m_remaining = 0;
+
+			public:
+				using iterator_category = std::forward_iterator_tag;
+				using value_type = element_type;
+				using reference = typename container_view::reference;
+				using pointer = void;
+				using difference_type = std::ptrdiff_t;
+
+				const_iterator( ) = default;
+
+				const_iterator( burp_impl::encoded_span pos, std::size_t remaining ) noexcept
+				  : m_pos( pos )
+				  , m_remaining( remaining ) {}
+
+				[[nodiscard]] reference operator*( ) const {
+					return burp_impl::make_lazy<element_type>( m_pos );
+				}
+
+				const_iterator &operator++( ) {
+					burp_impl::skip_impl1<element_type>( m_pos );
+					--m_remaining;
+					return *this;
+				}
+
+				const_iterator operator++( int ) {
+					auto result = *this;
+					operator++( );
+					return result;
+				}
+
+				friend bool operator==( const_iterator const &lhs, const_iterator const &rhs ) noexcept {
+					return lhs.m_remaining == rhs.m_remaining;
+				}
+
+				friend bool operator!=( const_iterator const &lhs, const_iterator const &rhs ) noexcept {
+					return lhs.m_remaining != rhs.m_remaining;
+				}
+			};
+
+			container_view( ) = default;
+
+			/// @param data A buffer that starts with an encoded Container
+			explicit container_view( burp_impl::encoded_span data ) noexcept
+			  : m_data( data ) {}
+
+			[[nodiscard]] std::size_t size( ) const {
+				auto in = m_data;
+				return burp_impl::read_size( in );
+			}
+
+			[[nodiscard]] bool empty( ) const {
+				return size( ) == 0;
+			}
+
+			[[nodiscard]] const_iterator begin( ) const {
+				auto const l = layout( );
+				return const_iterator( l.elements, l.size );
+			}
+
+			[[nodiscard]] const_iterator end( ) const {
+				return const_iterator( { }, 0 );
+			}
+
+			/// @brief The encoding of the element at index.  For indexed_container's the span ends with
+			/// the element, allowing ranges of elements to be handed to other threads to decode
+			[[nodiscard]] burp_impl::encoded_span element_data( std::size_t index ) const {
+				auto const l = layout( );
+				daw_burp_ensure( index < l.size, daw::burp::ErrorReason::InputError );
+				auto result = l.elements;
+				if constexpr( burp_impl::is_indexed_container_v<Container> ) {
+					auto const first = index == 0 ? std::uint64_t{ 0 } : index_entry( l, index - 1U );
+					auto const last = index_entry( l, index );
+					daw_burp_ensure( first <= last and last <= result.size( ),
+					                 daw::burp::ErrorReason::InputError );
+					return burp_impl::encoded_span( result.data( ) + first,
+					                                static_cast<std::size_t>( last - first ) );
+				} else if constexpr( element_encoded_size != burp_impl::dynamic_encoded_size ) {
+					burp_impl::skip_bytes( result, index * element_encoded_size );
+				} else {
+					for( std::size_t n = 0; n < index; ++n ) {
+						burp_impl::skip_impl1<element_type>( result );
+					}
+				}
+				return result;
+			}
+
+			[[nodiscard]] reference operator[]( std::size_t index ) const {
+				return burp_impl::make_lazy<element_type>( element_data( index ) );
+			}
+
+			/// @brief The encoded elements.  For contiguous containers of fundamental types this is
+			/// the raw element data, e.g. the characters of a string
+			[[nodiscard]] burp_impl::encoded_span payload( ) const {
+				auto rest = m_data;
+				burp_impl::skip_impl1<Container>( rest );
+				auto const payload_start = layout( ).elements.data( );
+				return burp_impl::encoded_span( payload_start, rest.data( ) - payload_start );
+			}
+
+			/// @brief The elements of an aligned_container in place in the encoded buffer
+			template<typename C = Container,
+			         std::enable_if_t<burp_impl::is_aligned_container_v<C>, std::nullptr_t> = nullptr>
+			[[nodiscard]] daw::span<element_type const> values( ) const {
+				auto const l = layout( );
+				daw_burp_ensure( reinterpret_cast<std::uintptr_t>( l.elements.data( ) ) %
+				                     alignof( element_type ) ==
+				                   0,
+				                 daw::burp::ErrorReason::InputError );
+				daw_burp_ensure( l.size <= l.elements.size( ) / sizeof( element_type ),
+				                 daw::burp::ErrorReason::InputError );
+				return daw::span<element_type const>(
+				  reinterpret_cast<element_type const *>( l.elements.data( ) ), l.size );
+			}
+
+			/// @brief Decode the whole container
+			[[nodiscard]] Container decode( ) const {
+				return read<Container>( m_data );
+			}
+		};
+
+		/// @brief A random access range of string_views into an encoded string_table.  No
+		/// characters are copied, the views refer to the encoded buffer.
+		template<typename Container>
+		class string_table_view {
+			static_assert( burp_impl::is_string_table_v<Container>,
+			               "string_table_view requires a string_table" );
+
+			char const *m_offsets = nullptr;
+			char const *m_chars = nullptr;
+			std::size_t m_size = 0;
+			std::size_t m_width = 0;
+			std::size_t m_total = 0;
+
+			[[nodiscard]] std::size_t end_offset( std::size_t index ) const {
+				auto const result = burp_impl::load_table_entry( m_offsets + index * m_width, m_width );
+				daw_burp_ensure( result <= m_total, daw::burp::ErrorReason::InputError );
+				return static_cast<std::size_t>( result );
+			}
+
+		public:
+			using value_type = std::string_view;
+			using reference = std::string_view;
+			using size_type = std::size_t;
+
+			class const_iterator {
+				string_table_view const *m_view = nullptr;
+				std::size_t m_index = 0;
+
+			public:
+				using iterator_category = std::random_access_iterator_tag;
+				using value_type = std::string_view;
+				using reference = std::string_view;
+				using pointer = void;
+				using difference_type = std::ptrdiff_t;
+
+				const_iterator( ) = default;
+
+				const_iterator( string_table_view const *v, std::size_t index ) noexcept
+				  : m_view( v )
+				  , m_index( index ) {}
+
+				[[nodiscard]] reference operator*( ) const {
+					return ( *m_view )[m_index];
+				}
+
+				[[nodiscard]] reference operator[]( difference_type n ) const {
+					return *( *this + n );
+				}
+
+				const_iterator &operator++( ) noexcept {
+					++m_index;
+					return *this;
+				}
+
+				const_iterator operator++( int ) noexcept {
+					auto result = *this;
+					++m_index;
+					return result;
+				}
+
+				const_iterator &operator--( ) noexcept {
+					--m_index;
+					return *this;
+				}
+
+				const_iterator operator--( int ) noexcept {
+					auto result = *this;
+					--m_index;
+					return result;
+				}
+
+				const_iterator &operator+=( difference_type n ) noexcept {
+					m_index = static_cast<std::size_t>( static_cast<difference_type>( m_index ) + n );
+					return *this;
+				}
+
+				const_iterator &operator-=( difference_type n ) noexcept {
+					return *this += -n;
+				}
+
+				[[nodiscard]] friend const_iterator operator+( const_iterator it,
+				                                               difference_type n ) noexcept {
+					return it += n;
+				}
+
+				[[nodiscard]] friend const_iterator operator-( const_iterator it,
+				                                               difference_type n ) noexcept {
+					return it -= n;
+				}
+
+				[[nodiscard]] friend difference_type operator-( const_iterator const &lhs,
+				                                                const_iterator const &rhs ) noexcept {
+					return static_cast<difference_type>( lhs.m_index ) -
+					       static_cast<difference_type>( rhs.m_index );
+				}
+
+				friend bool operator==( const_iterator const &lhs, const_iterator const &rhs ) noexcept {
+					return lhs.m_index == rhs.m_index;
+				}
+
+				friend bool operator!=( const_iterator const &lhs, const_iterator const &rhs ) noexcept {
+					return lhs.m_index != rhs.m_index;
+				}
+
+				friend bool operator<( const_iterator const &lhs, const_iterator const &rhs ) noexcept {
+					return lhs.m_index < rhs.m_index;
+				}
+			};
+
+			string_table_view( ) = default;
+
+			/// @param data A buffer that starts with an encoded string_table
+			explicit string_table_view( burp_impl::encoded_span data ) {
+				m_size = burp_impl::read_size( data );
+				m_width = burp_impl::read_string_table_width( data );
+				daw_burp_ensure( m_size <= data.size( ) / m_width, daw::burp::ErrorReason::InputError );
+				m_offsets = data.data( );
+				data.remove_prefix( m_size * m_width );
+				m_chars = data.data( );
+				if( m_size > 0 ) {
+					auto const total = burp_impl::load_table_entry( m_offsets + ( m_size - 1U ) * m_width,
+					                                                m_width );
+					daw_burp_ensure( total <= data.size( ), daw::burp::ErrorReason::InputError );
+					m_total = static_cast<std::size_t>( total );
+				}
+			}
+
+			[[nodiscard]] std::size_t size( ) const noexcept {
+				return m_size;
+			}
+
+			[[nodiscard]] bool empty( ) const noexcept {
+				return m_size == 0;
+			}
+
+			[[nodiscard]] const_iterator begin( ) const noexcept {
+				return const_iterator( this, 0 );
+			}
+
+			[[nodiscard]] const_iterator end( ) const noexcept {
+				return const_iterator( this, m_size );
+			}
+
+			[[nodiscard]] std::string_view operator[]( std::size_t index ) const {
+				daw_burp_ensure( index < m_size, daw::burp::ErrorReason::InputError );
+				auto const first = index == 0 ? std::size_t{ 0 } : end_offset( index - 1U );
+				auto const last = end_offset( index );
+				daw_burp_ensure( first <= last, daw::burp::ErrorReason::InputError );
+				return std::string_view( m_chars + first, last - first );
+			}
+
+			/// @brief All of the characters, back to back
+			[[nodiscard]] std::string_view characters( ) const noexcept {
+				return std::string_view( m_chars, m_total );
+			}
+
+			/// @brief The number of bytes used by the encoding
+			[[nodiscard]] std::size_t encoded_size( ) const noexcept {
+				return sizeof( std::size_t ) + sizeof( std::uint8_t ) + m_size * m_width + m_total;
+			}
+
+			/// @brief Decode the whole container
+			[[nodiscard]] Container decode( ) const {
+				auto result = Container( );
+				if constexpr( concepts::container_detect::is_reservable_container_v<Container> ) {
+					result.reserve( m_size );
+				}
+				for( auto const str : *this ) {
+					result.insert( std::end( result ),
+					               typename Container::value_type( str.data( ), str.size( ) ) );
+				}
+				return result;
+			}
+		};
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
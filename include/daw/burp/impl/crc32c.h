@@ -0,0 +1,149 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "version.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined( __SSE4_2__ )
+#include <nmmintrin.h>
+#define DAW_BURP_CRC32C_SSE42
+#elif defined( __x86_64__ ) and ( defined( __GNUC__ ) or defined( __clang__ ) )
+#include <nmmintrin.h>
+#define DAW_BURP_CRC32C_SSE42
+#define DAW_BURP_CRC32C_SSE42_DISPATCH
+#elif defined( __ARM_FEATURE_CRC32 )
+#include <arm_acle.h>
+#define DAW_BURP_CRC32C_ARM
+#endif
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace crc32c_impl {
+			// Reflected Castagnoli polynomial
+			inline constexpr std::uint32_t polynomial = 0x82F6'3B78U;
+
+			inline constexpr auto tables = [] {
+				auto result = std::array<std::array<std::uint32_t, 256>, 8>{ };
+				for( std::uint32_t n = 0; n < 256U; ++n ) {
+					auto c = n;
+					for( int k = 0; k < 8; ++k ) {
+						c = ( c & 1U ) != 0 ? ( c >> 1U ) ^ polynomial : c >> 1U;
+					}
+					result[0][n] = c;
+				}
+				for( std::size_t n = 0; n < 256U; ++n ) {
+					for( std::size_t t = 1; t < 8U; ++t ) {
+						auto const prev = result[t - 1U][n];
+						result[t][n] = ( prev >> 8U ) ^ result[0][prev & 0xFFU];
+					}
+				}
+				return result;
+			}( );
+
+			/// Slicing by 8 fallback, state is the pre/post inverted crc
+			inline std::uint32_t update_portable( std::uint32_t state,
+			                                      unsigned char const *ptr,
+			                                      std::size_t size ) noexcept {
+				while( size >= 8U ) {
+					std::uint32_t lo = 0;
+					std::uint32_t hi = 0;
+					std::memcpy( &lo, ptr, 4 );
+					std::memcpy( &hi, ptr + 4, 4 );
+#if defined( __BYTE_ORDER__ ) and __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+					lo = __builtin_bswap32( lo );
+					hi = __builtin_bswap32( hi );
+#endif
+					lo ^= state;
+					state = tables[7][lo & 0xFFU] ^ tables[6][( lo >> 8U ) & 0xFFU] ^
+					        tables[5][( lo >> 16U ) & 0xFFU] ^ tables[4][lo >> 24U] ^
+					        tables[3][hi & 0xFFU] ^ tables[2][( hi >> 8U ) & 0xFFU] ^
+					        tables[1][( hi >> 16U ) & 0xFFU] ^ tables[0][hi >> 24U];
+					ptr += 8;
+					size -= 8U;
+				}
+				while( size > 0 ) {
+					state = ( state >> 8U ) ^ tables[0][( state ^ *ptr ) & 0xFFU];
+					++ptr;
+					--size;
+				}
+				return state;
+			}
+
+#if defined( DAW_BURP_CRC32C_SSE42 )
+#if defined( DAW_BURP_CRC32C_SSE42_DISPATCH )
+			__attribute__( ( target( "sse4.2" ) ) )
+#endif
+			inline std::uint32_t
+			update_hw( std::uint32_t state, unsigned char const *ptr, std::size_t size ) noexcept {
+				std::uint64_t state64 = state;
+				while( size >= 8U ) {
+					std::uint64_t v = 0;
+					std::memcpy( &v, ptr, 8 );
+					state64 = _mm_crc32_u64( state64, v );
+					ptr += 8;
+					size -= 8U;
+				}
+				state = static_cast<std::uint32_t>( state64 );
+				while( size > 0 ) {
+					state = _mm_crc32_u8( state, *ptr );
+					++ptr;
+					--size;
+				}
+				return state;
+			}
+#elif defined( DAW_BURP_CRC32C_ARM )
+			inline std::uint32_t
+			update_hw( std::uint32_t state, unsigned char const *ptr, std::size_t size ) noexcept {
+				while( size >= 8U ) {
+					std::uint64_t v = 0;
+					std::memcpy( &v, ptr, 8 );
+					state = __crc32cd( state, v );
+					ptr += 8;
+					size -= 8U;
+				}
+				while( size > 0 ) {
+					state = __crc32cb( state, *ptr );
+					++ptr;
+					--size;
+				}
+				return state;
+			}
+#endif
+
+			inline bool has_hw_support( ) noexcept {
+#if defined( DAW_BURP_CRC32C_SSE42_DISPATCH )
+				static bool const result = __builtin_cpu_supports( "sse4.2" );
+				return result;
+#elif defined( DAW_BURP_CRC32C_SSE42 ) or defined( DAW_BURP_CRC32C_ARM )
+				return true;
+#else
+				return false;
+#endif
+			}
+		} // namespace crc32c_impl
+
+		/// @brief Extend a CRC32C(Castagnoli) with more data.  Start with a crc of 0 and pass the
+		/// previous result to continue a running checksum.  Uses the SSE4.2/ARMv8 crc32 instructions
+		/// when available.
+		inline std::uint32_t crc32c( std::uint32_t crc, void const *data, std::size_t size ) noexcept {
+			auto const *ptr = static_cast<unsigned char const *>( data );
+#if defined( DAW_BURP_CRC32C_SSE42 ) or defined( DAW_BURP_CRC32C_ARM )
+			if( crc32c_impl::has_hw_support( ) ) {
+				return ~crc32c_impl::update_hw( ~crc, ptr, size );
+			}
+#endif
+			return ~crc32c_impl::update_portable( ~crc, ptr, size );
+		}
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
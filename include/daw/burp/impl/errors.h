@@ -13,6 +13,8 @@ namespace daw::burp {
 		enum ErrorReason {
 			None,
 			OutputError,
+			InputError,
+			ChecksumError,
 		};
 
 	} // namespace DAW_BURP_VER
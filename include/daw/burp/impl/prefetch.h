@@ -0,0 +1,48 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "version.h"
+
+#include <cstddef>
+
+#if defined( _MSC_VER ) and not defined( __clang__ ) and                                           \
+  ( defined( _M_X64 ) or defined( _M_IX86 ) )
+#include <xmmintrin.h>
+#define DAW_BURP_PREFETCH_MM
+#endif
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			inline constexpr std::size_t cache_line_size = 64U;
+
+			/// Hint that the cache line at ptr will be read soon.  A no-op where there is no way to
+			/// express it
+			inline void prefetch( void const *ptr ) noexcept {
+#if defined( __GNUC__ ) or defined( __clang__ )
+				__builtin_prefetch( ptr, 0, 3 );
+#elif defined( DAW_BURP_PREFETCH_MM )
+				_mm_prefetch( static_cast<char const *>( ptr ), _MM_HINT_T0 );
+#else
+				(void)ptr;
+#endif
+			}
+
+			/// Prefetch every cache line that the object at ptr occupies
+			template<typename T>
+			inline void prefetch_object( T const *ptr ) noexcept {
+				auto const *first = reinterpret_cast<char const *>( ptr );
+				for( std::size_t n = 0; n < sizeof( T ); n += cache_line_size ) {
+					prefetch( first + n );
+				}
+			}
+		} // namespace burp_impl
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
@@ -0,0 +1,111 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#pragma once
+
+#include "version.h"
+
+#if __has_include( <unistd.h> ) and __has_include( <pthread.h> )
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace daw::burp {
+	inline namespace DAW_BURP_VER {
+		namespace burp_impl {
+			inline constexpr bool has_msg_nosignal =
+#if defined( MSG_NOSIGNAL )
+			  true;
+#else
+			  false;
+#endif
+
+			/// Does fd refer to a socket
+			[[nodiscard]] inline bool is_socket_fd( int fd ) noexcept {
+				struct ::stat st{ };
+				return ::fstat( fd, &st ) == 0 and S_ISSOCK( st.st_mode );
+			}
+
+			/// Block SIGPIPE on the calling thread while alive, so that a write to a pipe or socket
+			/// whose reader has gone fails with EPIPE instead of ending the process.  A SIGPIPE raised
+			/// meanwhile is discarded unless one was already pending
+			class sigpipe_blocker {
+				sigset_t m_old{ };
+				bool m_is_active = false;
+				bool m_was_pending = false;
+
+			public:
+				explicit sigpipe_blocker( bool is_needed = true ) noexcept {
+					if( not is_needed ) {
+						return;
+					}
+					sigset_t pending{ };
+					sigemptyset( &pending );
+					m_was_pending = sigpending( &pending ) == 0 and sigismember( &pending, SIGPIPE ) == 1;
+					sigset_t set{ };
+					sigemptyset( &set );
+					sigaddset( &set, SIGPIPE );
+					m_is_active = pthread_sigmask( SIG_BLOCK, &set, &m_old ) == 0;
+				}
+
+				sigpipe_blocker( sigpipe_blocker const & ) = delete;
+				sigpipe_blocker &operator=( sigpipe_blocker const & ) = delete;
+
+				~sigpipe_blocker( ) {
+					if( not m_is_active ) {
+						return;
+					}
+					auto const saved_errno = errno;
+					if( not m_was_pending ) {
+						sigset_t pending{ };
+						sigemptyset( &pending );
+						if( sigpending( &pending ) == 0 and sigismember( &pending, SIGPIPE ) == 1 ) {
+							sigset_t set{ };
+							sigemptyset( &set );
+							sigaddset( &set, SIGPIPE );
+							int sig = 0;
+							(void)sigwait( &set, &sig );
+						}
+					}
+					(void)pthread_sigmask( SIG_SETMASK, &m_old, nullptr );
+					errno = saved_errno;
+				}
+			};
+
+			/// writev, except that a socket is written with MSG_NOSIGNAL.  Other descriptors need a
+			/// sigpipe_blocker around the call to get EPIPE rather than SIGPIPE
+			[[nodiscard]] inline ssize_t write_iov( int fd,
+			                                        bool is_socket,
+			                                        iovec const *iov,
+			                                        int count ) noexcept {
+#if defined( MSG_NOSIGNAL )
+				if( is_socket ) {
+					msghdr msg{ };
+					msg.msg_iov = const_cast<iovec *>( iov );
+					msg.msg_iovlen = static_cast<decltype( msg.msg_iovlen )>( count );
+					return ::sendmsg( fd, &msg, MSG_NOSIGNAL );
+				}
+#else
+				(void)is_socket;
+#endif
+				return ::writev( fd, iov, count );
+			}
+
+			/// Does writing fd with write_iov need a sigpipe_blocker
+			[[nodiscard]] inline bool needs_sigpipe_blocker( bool is_socket ) noexcept {
+				return not( is_socket and has_msg_nosignal );
+			}
+		} // namespace burp_impl
+	} // namespace DAW_BURP_VER
+} // namespace daw::burp
+#endif
@@ -0,0 +1,85 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#include "daw_burp_benchmark.h"
+
+#include <daw/burp/daw_burp.h>
+#include <daw/burp/daw_burp_describe.h>
+
+#include <boost/describe.hpp>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Record {
+	int id;
+	std::string name;
+	std::vector<std::string> tags;
+	std::vector<double> values;
+};
+BOOST_DESCRIBE_STRUCT( Record, ( ), ( id, name, tags, values ) );
+
+struct PmrRecord {
+	int id;
+	std::pmr::string name;
+	std::pmr::vector<std::pmr::string> tags;
+	std::pmr::vector<double> values;
+};
+BOOST_DESCRIBE_STRUCT( PmrRecord, ( ), ( id, name, tags, values ) );
+
+static std::vector<Record> get_records( std::size_t count ) {
+	auto result = std::vector<Record>( );
+	result.reserve( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		auto const id = static_cast<int>( n );
+		result.push_back( Record{ id,
+		                          "record name that is past the sso limit " + std::to_string( n ),
+		                          { "tag_a_that_is_past_the_sso_limit", "tag_b" },
+		                          std::vector<double>( 8, static_cast<double>( n ) ) } );
+	}
+	return result;
+}
+
+static constexpr std::size_t NUM_RUNS = 10;
+
+int main( ) {
+#if not defined( NDEBUG )
+	constexpr std::size_t record_count = 1'000ULL;
+#else
+	constexpr std::size_t record_count = 100'000ULL;
+#endif
+	auto buff = std::string( );
+	daw::burp::write( buff, get_records( record_count ) );
+	auto const data = std::string_view( buff );
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data.size( ), "Read with global allocator", [&] {
+		auto result = daw::burp::read<std::vector<Record>>( data );
+		daw::do_not_optimize( result );
+		return result.size( );
+	} );
+
+	auto arena = std::pmr::monotonic_buffer_resource( data.size( ) * 2U );
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data.size( ), "Read with arena", [&] {
+		std::size_t result_size = 0;
+		{
+			auto result = daw::burp::read<std::pmr::vector<PmrRecord>>( data, &arena );
+			daw::do_not_optimize( result );
+			result_size = result.size( );
+		}
+		arena.release( );
+		return result_size;
+	} );
+
+	auto const check = daw::burp::read<std::pmr::vector<PmrRecord>>( data, &arena );
+	daw_burp_ensure( check.size( ) == record_count and check.back( ).name.size( ) > 0,
+	                 daw::burp::ErrorReason::InputError );
+	std::cout << "Records: " << check.size( ) << '\n';
+}
@@ -0,0 +1,99 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#include "daw_burp_benchmark.h"
+
+#include <daw/burp/daw_burp.h>
+#include <daw/burp/daw_burp_describe.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/describe.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Sample {
+	std::int64_t id;
+	std::array<double, 7> values;
+};
+BOOST_DESCRIBE_STRUCT( Sample, ( ), ( id, values ) );
+
+// Distinct comparators give each traversal its own map type to specialize the traits for
+template<int>
+struct Less {
+	constexpr bool operator( )( std::int64_t lhs, std::int64_t rhs ) const noexcept {
+		return lhs < rhs;
+	}
+};
+
+using plain_map_t = std::map<std::int64_t, Sample, Less<0>>;
+using prefetch_map_t = std::map<std::int64_t, Sample, Less<1>>;
+using batch_map_t = std::map<std::int64_t, Sample, Less<2>>;
+
+namespace daw::burp::concepts {
+	template<>
+	struct node_traversal_traits<plain_map_t> {
+		static constexpr std::size_t prefetch_distance = 0;
+		static constexpr std::size_t batch_size = 0;
+	};
+
+	template<>
+	struct node_traversal_traits<batch_map_t> {
+		static constexpr std::size_t prefetch_distance = 0;
+		static constexpr std::size_t batch_size = 32;
+	};
+} // namespace daw::burp::concepts
+
+static constexpr std::size_t NUM_RUNS = 5;
+
+// Inserting in a random order leaves the nodes scattered in memory relative to key order
+static std::vector<std::int64_t> get_keys( std::size_t count ) {
+	auto result = std::vector<std::int64_t>( count );
+	std::iota( std::begin( result ), std::end( result ), std::int64_t{ 0 } );
+	std::shuffle( std::begin( result ), std::end( result ), std::mt19937_64( 42 ) );
+	return result;
+}
+
+template<typename Map>
+static std::size_t bench_map( daw::string_view title, std::vector<std::int64_t> const &keys ) {
+	auto map = Map( );
+	for( auto const key : keys ) {
+		auto const value = static_cast<double>( key );
+		map.emplace( key, Sample{ key, { value, value, value, value, value, value, value } } );
+	}
+	auto buff = std::string( );
+	auto const data_size = daw::burp::write( buff, map );
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, title, [&] {
+		buff.clear( );
+		auto const result = daw::burp::write( buff, map );
+		daw::do_not_optimize( buff );
+		return result;
+	} );
+	return data_size;
+}
+
+int main( ) {
+#if not defined( NDEBUG )
+	constexpr std::size_t node_count = 100'000ULL;
+#else
+	constexpr std::size_t node_count = 10'000'000ULL;
+#endif
+	auto const keys = get_keys( node_count );
+	auto const plain_size = bench_map<plain_map_t>( "Write map, plain loop", keys );
+	auto const prefetch_size = bench_map<prefetch_map_t>( "Write map, prefetch ahead", keys );
+	auto const batch_size = bench_map<batch_map_t>( "Write map, batched", keys );
+	daw_burp_ensure( plain_size == prefetch_size and plain_size == batch_size,
+	                 daw::burp::ErrorReason::OutputError );
+	std::cout << "Nodes: " << node_count << '\n';
+}
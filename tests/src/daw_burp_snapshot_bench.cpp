@@ -0,0 +1,100 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#include "daw_burp_benchmark.h"
+
+#include <daw/burp/daw_burp.h>
+#include <daw/burp/daw_burp_describe.h>
+#include <daw/burp/daw_burp_sealed_snapshot.h>
+
+#include <boost/describe.hpp>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined( DAW_BURP_HAS_SEALED_SNAPSHOT )
+struct Record {
+	int id;
+	std::string name;
+	std::vector<double> values;
+};
+BOOST_DESCRIBE_STRUCT( Record, ( ), ( id, name, values ) );
+
+static std::vector<Record> get_records( std::size_t count ) {
+	auto result = std::vector<Record>( );
+	result.reserve( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		result.push_back( Record{ static_cast<int>( n ),
+		                          "record name that is past the sso limit " + std::to_string( n ),
+		                          std::vector<double>( 16, static_cast<double>( n ) ) } );
+	}
+	return result;
+}
+
+static constexpr std::size_t NUM_RUNS = 5;
+static constexpr std::size_t SUBSCRIBER_COUNT = 8;
+
+// Each subscriber is a pipe drained by its own thread, send is called with each write end in turn
+template<typename Send>
+static std::size_t fan_out( Send &&send ) {
+	int write_ends[SUBSCRIBER_COUNT];
+	auto drains = std::vector<std::thread>( );
+	for( auto &write_end : write_ends ) {
+		int fds[2];
+		daw_burp_ensure( ::pipe( fds ) == 0, daw::burp::ErrorReason::OutputError );
+		(void)::fcntl( fds[1], F_SETPIPE_SZ, 1024 * 1024 );
+		write_end = fds[1];
+		drains.emplace_back( [read_end = fds[0]] {
+			auto buff = std::vector<char>( 1024U * 1024U );
+			while( ::read( read_end, buff.data( ), buff.size( ) ) > 0 ) {}
+			::close( read_end );
+		} );
+	}
+	std::size_t result = 0;
+	for( auto write_end : write_ends ) {
+		result += send( daw::burp::concepts::fd_t( write_end ) );
+		::close( write_end );
+	}
+	for( auto &drain : drains ) {
+		drain.join( );
+	}
+	return result;
+}
+
+int main( ) {
+#if not defined( NDEBUG )
+	constexpr std::size_t record_count = 10'000ULL;
+#else
+	constexpr std::size_t record_count = 500'000ULL;
+#endif
+	auto const records = get_records( record_count );
+	auto const data_size = daw::burp::calc_size( records ) * SUBSCRIBER_COUNT;
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, "Write to each subscriber", [&] {
+		return fan_out( [&]( daw::burp::concepts::fd_t out ) {
+			return daw::burp::write( out, records );
+		} );
+	} );
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, "Sealed snapshot + sendfile", [&] {
+		auto const snapshot = daw::burp::sealed_snapshot::create( records );
+		return fan_out( [&]( daw::burp::concepts::fd_t out ) {
+			snapshot.send_to( out );
+			return snapshot.size( );
+		} );
+	} );
+
+	std::cout << "Subscribers: " << SUBSCRIBER_COUNT << " Records: " << record_count << '\n';
+}
+#else
+int main( ) {
+	std::cout << "Sealed snapshots are not supported on this platform\n";
+}
+#endif
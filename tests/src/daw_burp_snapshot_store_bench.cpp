@@ -0,0 +1,102 @@
+// Copyright (c) Darrell Wright
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/beached/daw_burp
+//
+
+#include "daw_burp_benchmark.h"
+
+#include <daw/burp/daw_burp.h>
+#include <daw/burp/daw_burp_describe.h>
+#include <daw/burp/daw_burp_snapshot_store.h>
+#include <daw/temp_file.h>
+
+#include <boost/describe.hpp>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined( DAW_BURP_HAS_SNAPSHOT_STORE )
+struct Record {
+	int id;
+	std::string name;
+	std::vector<double> values;
+};
+BOOST_DESCRIBE_STRUCT( Record, ( ), ( id, name, values ) );
+
+using records_t = daw::burp::indexed_container<std::vector<Record>>;
+
+static records_t get_records( std::size_t count ) {
+	auto result = records_t( );
+	result.reserve( count );
+	for( std::size_t n = 0; n < count; ++n ) {
+		result.push_back( Record{ static_cast<int>( n ),
+		                          "record name that is past the sso limit " + std::to_string( n ),
+		                          std::vector<double>( 16, static_cast<double>( n ) ) } );
+	}
+	return result;
+}
+
+static constexpr std::size_t NUM_RUNS = 5;
+
+// Drop the file from the page cache so that the next load reads it from storage
+static void evict( std::string const &path ) {
+	int const fd = ::open( path.c_str( ), O_RDONLY );
+	if( fd >= 0 ) {
+#if defined( POSIX_FADV_DONTNEED )
+		(void)::posix_fadvise( fd, 0, 0, POSIX_FADV_DONTNEED );
+#endif
+		::close( fd );
+	}
+}
+
+// What a service does at startup before answering its first requests
+static int eager_startup( std::string const &path ) {
+	auto const records = daw::burp::load_snapshot( path ).read<records_t>( );
+	return records[records.size( ) / 2U].id;
+}
+
+static int lazy_startup( std::string const &path ) {
+	auto const snapshot = daw::burp::load_snapshot( path );
+	auto const records = snapshot.view_as<records_t>( );
+	return records[records.size( ) / 2U].get<0>( );
+}
+
+int main( ) {
+#if not defined( NDEBUG )
+	constexpr std::size_t record_count = 10'000ULL;
+#else
+	constexpr std::size_t record_count = 1'000'000ULL;
+#endif
+	auto const tmp = daw::unique_temp_file{ };
+	auto const path = std::string( tmp.native( ) );
+	auto const data_size = daw::burp::save_snapshot( path, get_records( record_count ) );
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, "Cold eager load", [&] {
+		evict( path );
+		return eager_startup( path );
+	} );
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, "Cold mapped view", [&] {
+		evict( path );
+		return lazy_startup( path );
+	} );
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, "Warm eager load", [&] {
+		return eager_startup( path );
+	} );
+
+	(void)daw::burp::benchmark::benchmark( NUM_RUNS, data_size, "Warm mapped view", [&] {
+		return lazy_startup( path );
+	} );
+
+	std::cout << "Records: " << record_count << " Snapshot size: " << data_size << '\n';
+}
+#else
+int main( ) {
+	std::cout << "Snapshot files are not supported on this platform\n";
+}
+#endif
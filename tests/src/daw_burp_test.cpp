@@ -7,17 +7,56 @@
 //
 
 #include <daw/burp/daw_burp.h>
+#include <daw/burp/daw_burp_append_log.h>
+#include <daw/burp/daw_burp_async.h>
+#include <daw/burp/daw_burp_buffer_pool.h>
+#include <daw/burp/daw_burp_checksum.h>
+#include <daw/burp/daw_burp_delta.h>
 #include <daw/burp/daw_burp_describe.h>
+#include <daw/burp/daw_burp_dictionary.h>
+#include <daw/burp/daw_burp_framing.h>
+#include <daw/burp/daw_burp_parallel_read.h>
+#include <daw/burp/daw_burp_sealed_snapshot.h>
+#include <daw/burp/daw_burp_sequence_writer.h>
+#include <daw/burp/daw_burp_sharded.h>
+#include <daw/burp/daw_burp_shm_ring.h>
+#include <daw/burp/daw_burp_small_output_buffer.h>
+#include <daw/burp/daw_burp_snapshot_store.h>
+#include <daw/burp/daw_burp_stream_reader.h>
+#include <daw/burp/daw_burp_tee_output.h>
+#include <daw/burp/daw_burp_view.h>
+
+#include <daw/temp_file.h>
 
 #include <boost/describe.hpp>
+#include <bitset>
 #include <cassert>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
+#if defined( DAW_BURP_HAS_SHM_RING )
+#include <sys/wait.h>
+#endif
+
+#if defined( DAW_HAS_UNISTD )
+#include <fcntl.h>
+#include <sys/socket.h>
+#endif
+
 struct X {
 	int m1;
 	int m2;
@@ -42,6 +81,85 @@ struct Foo {
 };
 BOOST_DESCRIBE_STRUCT( Foo, ( ), ( m0, m1, m2 ) );
 
+struct Log {
+	daw::burp::indexed_container<std::vector<Y>> entries;
+	int tail;
+};
+BOOST_DESCRIBE_STRUCT( Log, ( ), ( entries, tail ) );
+
+struct PmrY {
+	X m0;
+	std::pmr::string m1;
+	std::pmr::vector<std::pmr::string> m2;
+};
+BOOST_DESCRIBE_STRUCT( PmrY, ( ), ( m0, m1, m2 ) );
+
+enum class Color : int { red = 1, green = 2, blue = 300 };
+BOOST_DESCRIBE_ENUM( Color, red, green, blue );
+
+enum class Shade : std::uint16_t { light, dark };
+
+struct Pixel {
+	Color color;
+	Shade shade;
+	std::bitset<12> flags;
+	std::vector<bool> mask;
+};
+BOOST_DESCRIBE_STRUCT( Pixel, ( ), ( color, shade, flags, mask ) );
+
+struct Checkpoint {
+	Y head;
+	Z index;
+	std::vector<X> samples;
+	std::optional<Y> pending;
+	double load;
+};
+BOOST_DESCRIBE_STRUCT( Checkpoint, ( ), ( head, index, samples, pending, load ) );
+
+struct Series {
+	std::string name;
+	daw::burp::aligned_container<std::vector<double>> values;
+	daw::burp::aligned_container<std::vector<float>, 16> weights;
+	char tag;
+};
+BOOST_DESCRIBE_STRUCT( Series, ( ), ( name, values, weights, tag ) );
+
+// Counts how often it is visited
+struct Counted {
+	int value;
+};
+
+static std::size_t counted_visits = 0;
+
+namespace daw::burp {
+	template<>
+	struct generic_dto<Counted> {
+		static DAW_CONSTEVAL std::size_t member_count( ) {
+			return 1;
+		}
+
+		template<typename Value>
+		static auto to_tuple( Value &value ) noexcept {
+			++counted_visits;
+			return std::forward_as_tuple( value.value );
+		}
+	};
+} // namespace daw::burp
+
+using batched_map_t = std::map<int, std::string, std::less<>>;
+
+namespace daw::burp::concepts {
+	template<>
+	struct node_traversal_traits<batched_map_t> {
+		static constexpr std::size_t prefetch_distance = 0;
+		static constexpr std::size_t batch_size = 3;
+	};
+} // namespace daw::burp::concepts
+
+static bool is_from( std::pmr::memory_resource *resource, std::pmr::string const &str ) {
+	return str.get_allocator( ).resource( ) == resource;
+}
+
 int main( ) {
 	auto x0 = X{ 1, 2 };
 	auto tp_x0 = daw::burp::generic_dto<X>::to_tuple( x0 );
@@ -70,4 +188,1190 @@ int main( ) {
 		std::cout << (int)c << '\n';
 	}
 	std::cout << "-----\n";
+
+	{
+		auto const x1 = daw::burp::read<X>( std::string_view( buff ) );
+		assert( x1.m1 == 1 and x1.m2 == 2 );
+		auto in = std::string_view( buff );
+		auto const y1 = daw::burp::read<Y>( in );
+		assert( in.empty( ) );
+		assert( y1.m0.m1 == 1 and y1.m0.m2 == 2 and y1.m1 == y0.m1 );
+	}
+	{
+		auto const foo0 = Foo{ y0, { { 1, 2 }, { 3, 4 } }, std::make_shared<int>( 42 ) };
+		buff.clear( );
+		sz = daw::burp::write( buff, foo0 );
+		assert( sz == buff.size( ) and sz == daw::burp::calc_size( foo0 ) );
+		auto const foo1 = daw::burp::read<Foo>( std::string_view( buff ) );
+		assert( foo1.m0 and foo1.m0->m1 == y0.m1 );
+		assert( foo1.m1.size( ) == 2 and foo1.m1[1].m1 == 3 and foo1.m1[1].m2 == 4 );
+		assert( foo1.m2 and *foo1.m2 == 42 );
+	}
+	{
+		auto const z0 = Z{ { { "a", 1 }, { "b", 2 } } };
+		buff.clear( );
+		daw::burp::write( buff, z0 );
+		auto const z1 = daw::burp::read<Z>( std::string_view( buff ) );
+		assert( z1.kv == z0.kv );
+	}
+	{
+		auto const ys0 = std::vector<Y>{ y0, Y{ { 3, 4 }, "" } };
+		buff.clear( );
+		daw::burp::write( buff, ys0 );
+		auto const ys1 = daw::burp::read<std::vector<Y>>( std::string_view( buff ) );
+		assert( ys1.size( ) == 2 and ys1[0].m1 == y0.m1 and ys1[1].m0.m2 == 4 );
+		bool did_throw = false;
+		try {
+			auto const truncated = std::string_view( buff ).substr( 0, buff.size( ) - 1 );
+			(void)daw::burp::read<std::vector<Y>>( truncated );
+		} catch( daw::burp::ErrorReason e ) {
+			did_throw = e == daw::burp::ErrorReason::InputError;
+		}
+		assert( did_throw );
+	}
+	{
+		// Appending many messages to one buffer grows it geometrically
+		auto out = std::vector<char>( );
+		std::size_t reallocations = 0;
+		for( std::int64_t n = 0; n < 20000; ++n ) {
+			auto const *before = out.data( );
+			(void)daw::burp::write( out, n );
+			reallocations += before != out.data( ) ? 1U : 0U;
+		}
+		assert( out.size( ) == 20000U * sizeof( std::int64_t ) and reallocations < 64U );
+		assert( daw::burp::read<std::int64_t>( daw::span<char const>( out.data( ) + 8, 8 ) ) == 1 );
+	}
+	{
+		auto const long_str = std::pmr::string( 100, 'a' );
+		auto const py0 =
+		  std::vector<PmrY>{ PmrY{ x0, long_str, { long_str } }, PmrY{ x0, long_str, { } } };
+		buff.clear( );
+		daw::burp::write( buff, py0 );
+		auto arena = std::pmr::monotonic_buffer_resource( );
+		auto const py1 = daw::burp::read<std::pmr::vector<PmrY>>( std::string_view( buff ), &arena );
+		assert( py1.size( ) == 2 and py1[1].m1 == long_str and py1[0].m2.size( ) == 1 );
+		assert( py1.get_allocator( ).resource( ) == &arena );
+		assert( is_from( &arena, py1[0].m1 ) and is_from( &arena, py1[1].m1 ) );
+		assert( is_from( &arena, py1[0].m2[0] ) );
+	}
+	{
+		auto small_buff = daw::burp::small_output_buffer<64>( );
+		daw::burp::write( small_buff, y0 );
+		assert( small_buff.is_inline( ) and small_buff.size( ) == daw::burp::calc_size( y0 ) );
+		auto const y1 = daw::burp::read<Y>( small_buff.span( ) );
+		assert( y1.m1 == y0.m1 );
+		auto const y2 = Y{ x0, std::string( 100, 'b' ) };
+		small_buff.clear( );
+		daw::burp::write( small_buff, y2 );
+		assert( not small_buff.is_inline( ) );
+		assert( daw::burp::read<Y>( small_buff.span( ) ).m1 == y2.m1 );
+		small_buff.clear( );
+		daw::burp::write( small_buff, y0 );
+		assert( small_buff.is_inline( ) and daw::burp::read<Y>( small_buff.span( ) ).m1 == y0.m1 );
+	}
+	{
+		auto pool = daw::burp::buffer_pool( );
+		for( int n = 0; n < 100; ++n ) {
+			auto out = daw::burp::pooled_output_buffer( pool );
+			daw::burp::write( out, y0 );
+			assert( daw::burp::read<Y>( out.span( ) ).m1 == y0.m1 );
+		}
+		auto const &stats = pool.stats( );
+		assert( stats.acquires == 100 and stats.hits == 99 and stats.hit_rate( ) > 0.9 );
+		assert( stats.blocks_retained == 1 and stats.bytes_retained > 0 );
+		// The first trim keeps what the peak demand needed, with no use since the next one frees it
+		pool.trim( );
+		assert( stats.blocks_retained == 1 );
+		pool.trim( );
+		assert( stats.blocks_retained == 0 and stats.bytes_retained == 0 );
+		// Blocks released on another thread are freed and taken out of the pool's counts
+		auto block = pool.acquire( 1000 );
+		std::thread( [b = std::move( block )]( ) mutable { b.reset( ); } ).join( );
+		pool.trim( );
+		assert( stats.releases == stats.acquires and stats.blocks_retained == 0 );
+	}
+	{
+		// Blocks can outlive their pool
+		auto block = daw::burp::pooled_block( );
+		{
+			auto pool = daw::burp::buffer_pool( );
+			block = pool.acquire( 100 );
+		}
+		assert( block and block.capacity( ) >= 100 );
+		block.data( )[99] = 'x';
+		block.reset( );
+	}
+	{
+		assert( daw::burp::crc32c( 0, "123456789", 9 ) == 0xE306'9283U );
+		auto const foo0 = Foo{ y0, { { 1, 2 }, { 3, 4 } }, nullptr };
+		buff.clear( );
+		sz = daw::burp::write_with_checksum( buff, foo0 );
+		assert( sz == buff.size( ) and sz == daw::burp::calc_size( foo0 ) + daw::burp::checksum_size );
+		auto const foo1 = daw::burp::read_with_checksum<Foo>( std::string_view( buff ) );
+		assert( foo1.m0->m1 == y0.m1 and foo1.m1.size( ) == 2 and not foo1.m2 );
+		buff[buff.size( ) / 2] ^= 1;
+		bool did_throw = false;
+		try {
+			(void)daw::burp::read_with_checksum<Foo>( std::string_view( buff ) );
+		} catch( daw::burp::ErrorReason e ) {
+			did_throw = e == daw::burp::ErrorReason::ChecksumError;
+		}
+		assert( did_throw );
+		// A corrupt count is checked against the input before anything is allocated for it
+		static_assert( daw::burp::concepts::has_readable_input_size_v<
+		               daw::burp::burp_impl::checksummed_input<std::string_view>> );
+		buff.clear( );
+		(void)daw::burp::write_with_checksum( buff, std::vector<int>{ 1, 2, 3 } );
+		buff[5] = 1;
+		did_throw = false;
+		try {
+			(void)daw::burp::read_with_checksum<std::vector<int>>( std::string_view( buff ) );
+		} catch( daw::burp::ErrorReason e ) {
+			did_throw = e == daw::burp::ErrorReason::InputError;
+		}
+		assert( did_throw );
+	}
+	{
+		auto const ys0 = std::vector<Y>{ y0, Y{ { 3, 4 }, "second" }, Y{ { 5, 6 }, "third" } };
+		buff.clear( );
+		daw::burp::write( buff, ys0 );
+		auto const ys_view = daw::burp::container_view<std::vector<Y>>( daw::span<char const>( buff ) );
+		assert( ys_view.size( ) == 3 );
+		auto const y2 = ys_view[2];
+		auto const x2 = y2.get<0>( );
+		assert( x2.m1 == 5 and x2.m2 == 6 );
+		assert( y2.get<1>( ).decode( ) == "third" and y2.get<1>( ).payload( ).size( ) == 5 );
+		std::size_t count = 0;
+		for( auto const y : ys_view ) {
+			assert( daw::burp::get<1>( y ).decode( ) == ys0[count].m1 );
+			++count;
+		}
+		assert( count == 3 );
+
+		auto const foo0 = Foo{ y0, { { 1, 2 }, { 3, 4 } }, std::make_shared<int>( 5 ) };
+		buff.clear( );
+		daw::burp::write( buff, foo0 );
+		auto const foo_view = daw::burp::view<Foo>( daw::span<char const>( buff ) );
+		assert( foo_view.encoded_size( ) == buff.size( ) );
+		assert( foo_view.get<1>( )[1].m2 == 4 );
+		assert( *foo_view.get<2>( ) == 5 );
+	}
+	{
+		auto log0 = Log{ { }, 42 };
+		for( int n = 0; n < 10; ++n ) {
+			log0.entries.push_back( Y{ { n, n }, std::string( static_cast<std::size_t>( n ), 'x' ) } );
+		}
+		buff.clear( );
+		daw::burp::write( buff, log0 );
+		auto const log1 = daw::burp::read<Log>( std::string_view( buff ) );
+		assert( log1.tail == 42 and log1.entries.size( ) == 10 and log1.entries[7].m1.size( ) == 7 );
+		auto const log_view = daw::burp::view<Log>( daw::span<char const>( buff ) );
+		assert( log_view.encoded_size( ) == buff.size( ) and log_view.get<1>( ) == 42 );
+		auto const entries = log_view.get<0>( );
+		static_assert( decltype( entries )::has_random_access );
+		auto const e7 = entries[7];
+		assert( e7.get<0>( ).m1 == 7 and e7.get<1>( ).decode( ) == log0.entries[7].m1 );
+		assert( entries.element_data( 7 ).size( ) == daw::burp::calc_size( log0.entries[7] ) );
+	}
+	{
+		auto y1 = Y{ { }, std::string( 64, 'z' ) };
+		auto const *y1_data = y1.m1.data( );
+		buff.clear( );
+		daw::burp::write( buff, y0 );
+		daw::burp::read_into( std::string_view( buff ), y1 );
+		assert( y1.m0.m2 == 2 and y1.m1 == y0.m1 and y1.m1.data( ) == y1_data );
+
+		auto *f = std::tmpfile( );
+		assert( f );
+		auto ss = std::stringstream( );
+		for( int n = 0; n < 1000; ++n ) {
+			auto const rec = Y{ { n, -n }, std::string( static_cast<std::size_t>( n % 17 ), 'r' ) };
+			daw::burp::write( f, rec );
+			daw::burp::write( ss, rec );
+		}
+		std::rewind( f );
+		auto reader = daw::burp::buffered_reader( f, 256 );
+		int count = 0;
+		for( auto const &rec : daw::burp::record_range<Y>( reader ) ) {
+			assert( rec.m0.m1 == count and rec.m1.size( ) == static_cast<std::size_t>( count % 17 ) );
+			++count;
+		}
+		assert( count == 1000 and reader.at_end( ) );
+		std::fclose( f );
+		count = 0;
+		for( auto const &rec : daw::burp::record_range<Y>( ss ) ) {
+			assert( rec.m0.m2 == -count );
+			++count;
+		}
+		assert( count == 1000 );
+
+		auto const ys0 = std::vector<Y>{ y0, Y{ { 3, 4 }, "second" }, Y{ { 5, 6 }, "third" } };
+		auto ss2 = std::stringstream( );
+		daw::burp::write( ss2, ys0 );
+		daw::burp::write( ss2, 42 );
+		auto reader2 = daw::burp::buffered_reader( ss2 );
+		count = 0;
+		for( auto const &y : daw::burp::element_range<std::vector<Y>>( reader2 ) ) {
+			assert( y.m1 == ys0[static_cast<std::size_t>( count )].m1 );
+			++count;
+		}
+		assert( count == 3 and daw::burp::read<int>( reader2 ) == 42 and reader2.at_end( ) );
+	}
+	{
+		buff.clear( );
+		{
+			auto seq = daw::burp::make_sequence_writer<Y>( buff );
+			assert( not seq.is_chunked( ) );
+			for( int n = 0; n < 100; ++n ) {
+				seq.push_back( Y{ { n, n }, "seq" } );
+			}
+		}
+		auto const ys1 = daw::burp::read<std::vector<Y>>( std::string_view( buff ) );
+		assert( ys1.size( ) == 100 and ys1[99].m0.m1 == 99 and ys1[0].m1 == "seq" );
+
+		auto ss = std::stringstream( );
+		ss << "x";
+		{
+			auto seq = daw::burp::make_sequence_writer<int>( ss );
+			seq.push_back( 1 );
+			seq.push_back( 2 );
+			seq.close( );
+			assert( seq.size( ) == 2 );
+		}
+		assert( ss.get( ) == 'x' );
+		assert( ( daw::burp::read<std::vector<int>>( ss ) == std::vector<int>{ 1, 2 } ) );
+
+		buff.clear( );
+		{
+			auto out = std::back_inserter( buff );
+			auto seq = daw::burp::make_sequence_writer<Y>( out, 32 );
+			assert( seq.is_chunked( ) );
+			for( int n = 0; n < 10; ++n ) {
+				seq.push_back( Y{ { n, n }, "it" } );
+			}
+		}
+		auto in = std::string_view( buff );
+		int count = 0;
+		for( auto const &y : daw::burp::element_range<std::vector<Y>>( in ) ) {
+			assert( y.m0.m1 == count and y.m1 == "it" );
+			++count;
+		}
+		assert( count == 10 and in.empty( ) );
+#if defined( DAW_HAS_UNISTD )
+		// Outputs opened for appending cannot patch the count in place
+		auto const tmp = daw::unique_temp_file{ };
+		auto const path = std::string( tmp.native( ) );
+		auto const read_back = [&] {
+			auto *f = std::fopen( path.c_str( ), "rb" );
+			assert( f );
+			auto const first = std::fgetc( f );
+			auto result = daw::burp::read_sequence<std::vector<int>>( f );
+			std::fclose( f );
+			return first == 'x' ? result : std::vector<int>{ };
+		};
+		{
+			auto *f = std::fopen( path.c_str( ), "wb" );
+			assert( f );
+			std::fputc( 'x', f );
+			std::fclose( f );
+			f = std::fopen( path.c_str( ), "ab" );
+			{
+				auto seq = daw::burp::make_sequence_writer<int>( f );
+				assert( seq.is_chunked( ) );
+				seq.push_back( 1 );
+				seq.push_back( 2 );
+			}
+			std::fclose( f );
+		}
+		assert( ( read_back( ) == std::vector<int>{ 1, 2 } ) );
+		{
+			int const fd = ::open( path.c_str( ), O_WRONLY | O_TRUNC );
+			assert( fd >= 0 );
+			auto const x_written = ::write( fd, "x", 1 );
+			assert( x_written == 1 );
+			::close( fd );
+			auto out = daw::burp::concepts::fd_t( ::open( path.c_str( ), O_WRONLY | O_APPEND ) );
+			assert( out.value >= 0 );
+			{
+				auto seq = daw::burp::make_sequence_writer<int>( out );
+				assert( seq.is_chunked( ) );
+				seq.push_back( 3 );
+			}
+			::close( out.value );
+		}
+		assert( ( read_back( ) == std::vector<int>{ 3 } ) );
+		{
+			auto os = std::ofstream( path, std::ios::binary | std::ios::app );
+			auto seq = daw::burp::make_sequence_writer<int>( os );
+			seq.push_back( 4 );
+			bool is_rejected = false;
+			try {
+				seq.close( );
+			} catch( daw::burp::ErrorReason e ) {
+				is_rejected = e == daw::burp::ErrorReason::OutputError;
+			}
+			assert( is_rejected );
+		}
+#endif
+	}
+	{
+		auto const values = std::map<int, X>{ { 1, { 1, 1 } }, { 2, { 2, 2 } }, { 3, { 3, 3 } } };
+		buff.clear( );
+		auto const first = std::next( values.begin( ) );
+		auto const tail_range = daw::burp::iterator_range( first, values.end( ) );
+		sz = daw::burp::write( buff, tail_range );
+		auto const tail = daw::burp::read<std::vector<std::pair<int, X>>>( std::string_view( buff ) );
+		assert( sz == buff.size( ) and tail.size( ) == 2 and tail[1].second.m2 == 3 );
+
+		auto numbers = std::istringstream( "1 2 3 4 5" );
+		buff.clear( );
+		auto const count = daw::burp::write_range(
+		  buff, std::istream_iterator<int>( numbers ), std::istream_iterator<int>( ) );
+		auto const ints = daw::burp::read<std::vector<int>>( std::string_view( buff ) );
+		assert( count == 5 and ints.size( ) == 5 and ints[4] == 5 );
+	}
+	{
+		auto names = daw::burp::string_table<std::vector<std::string>>( );
+		for( int n = 0; n < 300; ++n ) {
+			names.push_back( "id" + std::to_string( n ) );
+		}
+		names.push_back( "" );
+		buff.clear( );
+		sz = daw::burp::write( buff, names );
+		auto const &plain_names = static_cast<std::vector<std::string> const &>( names );
+		assert( sz == buff.size( ) and sz < daw::burp::calc_size( plain_names ) );
+		auto const names1 = daw::burp::read<decltype( names )>( std::string_view( buff ) );
+		assert( names1 == names );
+		auto ss = std::stringstream( buff );
+		assert( daw::burp::read<decltype( names )>( ss ) == names );
+		auto const names_view = daw::burp::string_table_view<decltype( names )>( buff );
+		assert( names_view.size( ) == 301 and names_view[299] == "id299" and names_view[300].empty( ) );
+		assert( names_view.encoded_size( ) == buff.size( ) );
+		assert( names_view.characters( ).data( ) + names_view.characters( ).size( ) ==
+		        buff.data( ) + buff.size( ) );
+		auto const tail = std::vector<std::string_view>( names_view.begin( ) + 298, names_view.end( ) );
+		assert( tail.size( ) == 3 and tail[0] == "id298" );
+
+		auto const log_tail = std::make_pair( names, 7 );
+		buff.clear( );
+		daw::burp::write( buff, log_tail );
+		auto in = std::string_view( buff );
+		daw::burp::burp_impl::skip_impl1<decltype( names )>( in );
+		assert( daw::burp::read<int>( in ) == 7 );
+	}
+	{
+		auto zs0 = std::vector<Z>( );
+		for( int n = 0; n < 1000; ++n ) {
+			auto region = "region_" + std::to_string( n % 3 );
+			zs0.push_back( Z{ { { "temperature", n }, { "humidity", n % 7 }, { region, 1 } } } );
+		}
+		buff.clear( );
+		sz = daw::burp::write_with_dictionary( buff, zs0 );
+		assert( sz == buff.size( ) and sz == daw::burp::calc_size_with_dictionary( zs0 ) );
+		assert( sz * 3 < daw::burp::calc_size( zs0 ) );
+		auto const zs1 = daw::burp::read_with_dictionary<std::vector<Z>>( std::string_view( buff ) );
+		assert( zs1.size( ) == 1000 and zs1[999].kv == zs0[999].kv );
+		auto ss = std::stringstream( buff );
+		assert( daw::burp::read_with_dictionary<std::vector<Z>>( ss )[500].kv == zs0[500].kv );
+
+		auto const foo0 = Foo{ y0, { { 1, 2 } }, nullptr };
+		buff.clear( );
+		daw::burp::write_with_dictionary( buff, foo0 );
+		auto const foo1 = daw::burp::read_with_dictionary<Foo>( std::string_view( buff ) );
+		assert( foo1.m0->m1 == y0.m1 and foo1.m1.size( ) == 1 and not foo1.m2 );
+
+		// The index table of an indexed_container counts the codes that replace its strings
+		using indexed_strings_t = daw::burp::indexed_container<std::vector<std::string>>;
+		auto const strs = indexed_strings_t{ std::string( 24, 'a' ), std::string( 24, 'b' ) };
+		buff.clear( );
+		sz = daw::burp::write_with_dictionary( buff, strs );
+		assert( sz == buff.size( ) and sz == daw::burp::calc_size_with_dictionary( strs ) );
+		// Two one byte codes follow the table
+		auto const last_end = daw::burp::burp_impl::load_table_entry( buff.data( ) + sz - 2 - 4, 4 );
+		assert( last_end == 2 );
+		assert( daw::burp::read_with_dictionary<indexed_strings_t>( std::string_view( buff ) ) ==
+		        strs );
+	}
+	{
+		static_assert( sizeof( daw::burp::concepts::enum_encoding_t<Color> ) == 2 );
+		static_assert( daw::burp::burp_impl::is_contiguous_array_of_fundamental_like_types_v<
+		               std::vector<Shade>> );
+		auto mask = std::vector<bool>( 100 );
+		for( std::size_t n = 0; n < mask.size( ); n += 3 ) {
+			mask[n] = true;
+		}
+		auto const pixel0 = Pixel{ Color::blue, Shade::dark, std::bitset<12>( 0xA5FU ), mask };
+		buff.clear( );
+		sz = daw::burp::write( buff, pixel0 );
+		assert( sz == 2 + 2 + 2 + sizeof( std::size_t ) + 13 );
+		auto const pixel1 = daw::burp::read<Pixel>( std::string_view( buff ) );
+		assert( pixel1.color == Color::blue and pixel1.shade == Shade::dark );
+		assert( pixel1.flags == pixel0.flags and pixel1.mask == mask );
+		assert( daw::burp::view<Pixel>( daw::span<char const>( buff ) ).get<3>( ) == mask );
+
+		auto const big = std::bitset<100>( ).set( 0 ).set( 64 ).set( 99 );
+		buff.clear( );
+		auto const big_size = daw::burp::write( buff, big );
+		assert( big_size == 13 );
+		assert( daw::burp::read<std::bitset<100>>( std::string_view( buff ) ) == big );
+		auto const shades = std::vector<Shade>{ Shade::dark, Shade::light };
+		buff.clear( );
+		daw::burp::write( buff, shades );
+		assert( daw::burp::read<std::vector<Shade>>( std::string_view( buff ) ) == shades );
+		bool did_throw = false;
+		try {
+			daw::burp::write( buff, static_cast<Color>( 70000 ) );
+		} catch( daw::burp::ErrorReason e ) {
+			did_throw = e == daw::burp::ErrorReason::OutputError;
+		}
+		assert( did_throw );
+#if defined( DAW_HAS_UNISTD )
+		int fds[2];
+		int const pipe_result = ::pipe( fds );
+		assert( pipe_result == 0 );
+		{
+			auto out = daw::burp::concepts::fd_t( fds[1] );
+			auto seq = daw::burp::make_sequence_writer<Y>( out, 64 );
+			assert( seq.is_chunked( ) );
+			for( int n = 0; n < 100; ++n ) {
+				seq.push_back( Y{ { n, -n }, "chunked" } );
+			}
+		}
+		::close( fds[1] );
+		auto reader = daw::burp::buffered_reader( daw::burp::concepts::fd_t( fds[0] ) );
+		auto const ys2 = daw::burp::read_sequence<std::vector<Y>>( reader );
+		assert( ys2.size( ) == 100 and ys2[42].m0.m2 == -42 and ys2[99].m1 == "chunked" );
+		assert( reader.at_end( ) );
+		::close( fds[0] );
+#endif
+	}
+	{
+		// Segmented containers are encoded the same as contiguous ones
+		auto dq = std::deque<int>( );
+		for( int n = 0; n < 5000; ++n ) {
+			dq.push_front( n );
+		}
+		auto const vec = std::vector<int>( dq.begin( ), dq.end( ) );
+		auto buff = std::string( );
+		daw::burp::write( buff, dq );
+		auto vec_buff = std::string( );
+		daw::burp::write( vec_buff, vec );
+		assert( buff == vec_buff );
+		assert( daw::burp::read<std::deque<int>>( std::string_view( buff ) ) == dq );
+		auto dq2 = std::deque<int>( 3, -1 );
+		daw::burp::read_into( std::string_view( buff ), dq2 );
+		assert( dq2 == dq );
+	}
+	{
+		// Node containers are traversed with prefetching, or in batches when specialized
+		auto const names = std::list<std::string>{ "a", "bb", "ccc", "dddd" };
+		auto buff = std::string( );
+		daw::burp::write( buff, names );
+		assert( daw::burp::read<std::list<std::string>>( std::string_view( buff ) ) == names );
+		auto batched = batched_map_t( );
+		for( int n = 0; n < 10; ++n ) {
+			batched.emplace( n, std::to_string( n * n ) );
+		}
+		buff.clear( );
+		daw::burp::write( buff, batched );
+		assert( daw::burp::read<batched_map_t>( std::string_view( buff ) ) == batched );
+		auto const plain = std::map<int, std::string>( batched.begin( ), batched.end( ) );
+		auto plain_buff = std::string( );
+		daw::burp::write( plain_buff, plain );
+		assert( buff == plain_buff );
+	}
+#if defined( DAW_BURP_HAS_SHM_RING ) and defined( MFD_CLOEXEC )
+	{
+		// A second mapping of the same memory stands in for the consuming process
+		auto ring = daw::burp::shm_ring::create_anonymous( 4, 256 );
+		auto consumer = daw::burp::shm_ring::from_fd( ::dup( ring.fd( ) ) );
+		assert( consumer.slot_count( ) == 4 and consumer.max_message_size( ) >= 256 );
+		ring.push( Y{ { 1, 2 }, "in place" } );
+		{
+			auto const message = consumer.pop( );
+			auto const y = daw::burp::read<Y>( message.data( ) );
+			assert( y.m0.m2 == 2 and y.m1 == "in place" );
+		}
+		bool const is_empty = not consumer.try_pop( );
+		assert( is_empty );
+		for( int n = 0; n < 4; ++n ) {
+			bool const is_pushed = ring.try_push( n );
+			assert( is_pushed );
+		}
+		bool const is_full = not ring.try_push( 4 );
+		assert( is_full );
+		for( int n = 0; n < 4; ++n ) {
+			auto const value = daw::burp::read<int>( consumer.pop( ).data( ) );
+			assert( value == n );
+		}
+		bool did_throw = false;
+		try {
+			ring.push( std::string( 1000, 'x' ) );
+		} catch( daw::burp::ErrorReason e ) {
+			did_throw = e == daw::burp::ErrorReason::OutputError;
+		}
+		assert( did_throw );
+		// The abandoned slot is skipped
+		bool const is_skipped = not consumer.try_pop( );
+		assert( is_skipped );
+
+		// More messages than slots so that both sides wait on each other
+		pid_t const pid = ::fork( );
+		assert( pid >= 0 );
+		if( pid == 0 ) {
+			for( int n = 0; n < 1000; ++n ) {
+				ring.push( Y{ { n, -n }, "from the producer" } );
+			}
+			::_exit( 0 );
+		}
+		for( int n = 0; n < 1000; ++n ) {
+			auto const y = daw::burp::read<Y>( consumer.pop( ).data( ) );
+			assert( y.m0.m1 == n and y.m1 == "from the producer" );
+		}
+		int status = 0;
+		pid_t const waited = ::waitpid( pid, &status, 0 );
+		assert( waited == pid and WIFEXITED( status ) );
+	}
+	{
+		// A header from another process is held to the same limits as create
+		auto const ring = daw::burp::shm_ring::create_anonymous( 4, 256 );
+		std::uint64_t geometry[2] = { };
+		auto const read_result = ::pread( ring.fd( ), geometry, sizeof( geometry ), 8 );
+		assert( read_result == sizeof( geometry ) );
+		auto const opens_with = [&]( std::uint64_t slot_count, std::uint64_t slot_size ) {
+			std::uint64_t const bad[2] = { slot_count, slot_size };
+			auto const write_result = ::pwrite( ring.fd( ), bad, sizeof( bad ), 8 );
+			assert( write_result == sizeof( bad ) );
+			bool is_opened = true;
+			try {
+				(void)daw::burp::shm_ring::from_fd( ::dup( ring.fd( ) ) );
+			} catch( daw::burp::ErrorReason e ) {
+				is_opened = e != daw::burp::ErrorReason::InputError;
+			}
+			return is_opened;
+		};
+		bool const is_count_checked = not opens_with( 3, geometry[1] );
+		bool const is_size_checked = not opens_with( geometry[0], geometry[1] - 4U );
+		bool const is_valid_opened = opens_with( geometry[0], geometry[1] );
+		assert( is_count_checked and is_size_checked and is_valid_opened );
+	}
+#endif
+#if defined( DAW_BURP_HAS_APPEND_LOG )
+	{
+		auto const tmp = daw::unique_temp_file{ };
+		auto const path = std::string( tmp.native( ) );
+		auto options = daw::burp::append_log_options{ };
+		options.max_size = std::size_t{ 1 } << 26U;
+		options.grow_size = std::size_t{ 1 } << 16U;
+		options.flush_interval = std::chrono::milliseconds( 1 );
+		constexpr int producer_count = 4;
+		constexpr int record_count = 2000;
+		{
+			auto log = daw::burp::append_log( path, options );
+			auto producers = std::vector<std::thread>( );
+			for( int p = 0; p < producer_count; ++p ) {
+				producers.emplace_back( [&log, p] {
+					for( int n = 0; n < record_count; ++n ) {
+						log.append( Y{ { p, n }, std::string( static_cast<std::size_t>( n % 13 ), 'r' ) } );
+					}
+				} );
+			}
+			for( auto &producer : producers ) {
+				producer.join( );
+			}
+			log.flush( );
+		}
+		auto const read_log = [&] {
+			auto file = std::fopen( path.c_str( ), "rb" );
+			auto data = std::string( );
+			char buff[4096];
+			std::size_t count = 0;
+			while( ( count = std::fread( buff, 1, sizeof( buff ), file ) ) > 0 ) {
+				data.append( buff, count );
+			}
+			std::fclose( file );
+			return data;
+		};
+		auto data = read_log( );
+		auto next = std::vector<int>( producer_count, 0 );
+		auto const end = daw::burp::for_each_log_record(
+		  daw::span<char const>( data.data( ), data.size( ) ),
+		  [&]( daw::span<char const> record ) {
+			  auto const y = daw::burp::read<Y>( record );
+			  // Records of one producer are in the order they were appended
+			  assert( y.m0.m2 == next[static_cast<std::size_t>( y.m0.m1 )] );
+			  assert( y.m1.size( ) == static_cast<std::size_t>( y.m0.m2 % 13 ) );
+			  ++next[static_cast<std::size_t>( y.m0.m1 )];
+		  } );
+		assert( end == data.size( ) );
+		for( auto const count : next ) {
+			assert( count == record_count );
+		}
+		{
+			// Reopening continues after the last record
+			auto log = daw::burp::append_log( path, options );
+			log.append( Y{ { -1, -1 }, "reopened" } );
+		}
+		data = read_log( );
+		std::size_t records = 0;
+		auto last = Y{ };
+		daw::burp::for_each_log_record( daw::span<char const>( data.data( ), data.size( ) ),
+		                                [&]( daw::span<char const> record ) {
+			                                last = daw::burp::read<Y>( record );
+			                                ++records;
+		                                } );
+		assert( records == producer_count * record_count + 1 and last.m1 == "reopened" );
+		// A producer that died between reserving and committing does not hide the records after it
+		auto const raw_record = [&]( std::uint32_t state, std::string const &payload ) {
+			auto const header = daw::burp::burp_impl::append_log_header(
+			  static_cast<std::uint32_t>( payload.size( ) ), state );
+			auto result = std::string( reinterpret_cast<char const *>( &header ), sizeof( header ) );
+			result += payload;
+			result.resize( daw::burp::burp_impl::append_log_stride( payload.size( ) ), '\0' );
+			return result;
+		};
+		{
+			auto encoded = std::string( );
+			daw::burp::write( encoded, Y{ { -2, -2 }, "after crash" } );
+			auto *f = std::fopen( path.c_str( ), "ab" );
+			assert( f );
+			auto const raw = raw_record( daw::burp::burp_impl::append_log_reserved, "torn" ) +
+			                 raw_record( daw::burp::burp_impl::append_log_committed, encoded );
+			std::fwrite( raw.data( ), 1, raw.size( ), f );
+			std::fclose( f );
+			auto log = daw::burp::append_log( path, options );
+			log.append( Y{ { -3, -3 }, "recovered" } );
+		}
+		data = read_log( );
+		auto names = std::vector<std::string>( );
+		daw::burp::for_each_log_record( daw::span<char const>( data.data( ), data.size( ) ),
+		                                [&]( daw::span<char const> record ) {
+			                                names.push_back( daw::burp::read<Y>( record ).m1 );
+		                                } );
+		assert( names.size( ) == producer_count * record_count + 3 );
+		assert( names[names.size( ) - 2] == "after crash" and names.back( ) == "recovered" );
+	}
+#endif
+#if defined( DAW_HAS_UNISTD )
+	{
+		// Both ends non-blocking and a small receive buffer so that frames arrive in pieces
+		int sockets[2];
+		int const pair_result = ::socketpair( AF_UNIX, SOCK_STREAM, 0, sockets );
+		assert( pair_result == 0 );
+		for( int s : sockets ) {
+			::fcntl( s, F_SETFL, ::fcntl( s, F_GETFL ) | O_NONBLOCK );
+		}
+		auto writer = daw::burp::frame_writer( sockets[0] );
+		auto reader = daw::burp::frame_reader( sockets[1], 16 );
+		auto const encoded = std::string( "pre-encoded" );
+		constexpr int message_count = 2000;
+		for( int n = 0; n < message_count; ++n ) {
+			if( n % 100 == 0 ) {
+				writer.push_encoded( daw::span<char const>( encoded.data( ), encoded.size( ) ) );
+			}
+			writer.push( Y{ { n, -n }, std::string( static_cast<std::size_t>( n % 300 ), 'f' ) } );
+		}
+		int received = 0;
+		int raw_received = 0;
+		bool is_sent = false;
+		while( received < message_count ) {
+			if( not is_sent ) {
+				is_sent = writer.flush( );
+			}
+			reader.fill( );
+			while( auto frame = reader.next_frame( ) ) {
+				if( std::string_view( frame->data( ), frame->size( ) ) == encoded ) {
+					++raw_received;
+					continue;
+				}
+				auto const y = daw::burp::read<Y>( *frame );
+				assert( y.m0.m1 == received and y.m1.size( ) == std::size_t( received % 300 ) );
+				++received;
+			}
+		}
+		assert( is_sent and writer.pending( ) == 0 and raw_received == message_count / 100 );
+		::close( sockets[0] );
+		reader.fill( );
+		assert( reader.is_closed( ) and reader.buffered( ) == 0 );
+		::close( sockets[1] );
+	}
+	{
+		// A reader that has gone is an OutputError, for a socket and a pipe, not a SIGPIPE
+		int sockets[2];
+		int const pair_result = ::socketpair( AF_UNIX, SOCK_STREAM, 0, sockets );
+		assert( pair_result == 0 );
+		int fds[2];
+		int const pipe_result = ::pipe( fds );
+		assert( pipe_result == 0 );
+		::close( sockets[1] );
+		::close( fds[0] );
+		for( int fd : { sockets[0], fds[1] } ) {
+			auto writer = daw::burp::frame_writer( fd );
+			writer.push( Y{ { 1, 2 }, "closed" } );
+			bool is_output_error = false;
+			try {
+				(void)writer.flush( );
+			} catch( daw::burp::ErrorReason e ) {
+				is_output_error = e == daw::burp::ErrorReason::OutputError;
+			}
+			assert( is_output_error );
+			::close( fd );
+		}
+	}
+#endif
+#if defined( DAW_BURP_HAS_EPOLL )
+	{
+		int sockets[2];
+		int const pair_result = ::socketpair( AF_UNIX, SOCK_STREAM, 0, sockets );
+		assert( pair_result == 0 );
+		for( int s : sockets ) {
+			::fcntl( s, F_SETFL, ::fcntl( s, F_GETFL ) | O_NONBLOCK );
+		}
+		auto loop = daw::burp::event_loop( );
+		auto writer = daw::burp::async_writer( loop, sockets[0], 4096 );
+		auto reader = daw::burp::async_reader( loop, sockets[1], 1024 );
+		// Larger than the socket buffers so that the writer has to wait for the reader
+		auto ys = std::vector<Y>( );
+		for( int n = 0; n < 20000; ++n ) {
+			ys.push_back( Y{ { n, n * 2 }, std::string( static_cast<std::size_t>( n % 50 ), 'a' ) } );
+		}
+		auto const map = std::map<std::string, int>{ { "one", 1 }, { "two", 2 } };
+		std::size_t written = 0;
+		bool is_map_read = false;
+		auto ys_read = std::vector<Y>( );
+		writer.write( ys ).then( [&]( auto result ) {
+			written += result.get( );
+			writer.write( map ).then( [&]( auto r ) { written += r.get( ); } );
+		} );
+		reader.read<std::vector<Y>>( ).then( [&]( auto result ) {
+			ys_read = result.get( );
+			reader.read<std::map<std::string, int>>( ).then( [&]( auto r ) {
+				is_map_read = r.get( ) == map;
+			} );
+		} );
+		loop.run( );
+		assert( ys_read.size( ) == ys.size( ) and ys_read.back( ).m1 == ys.back( ).m1 );
+		assert( is_map_read );
+		assert( written == daw::burp::calc_size( ys ) + daw::burp::calc_size( map ) + 16 );
+		// Padding of aligned_container's nested in elements matches calc_size across chunks
+		using floats_t = daw::burp::aligned_container<std::vector<float>>;
+		auto const aligned =
+		  std::vector<floats_t>{ floats_t{ 1.0F, 2.0F, 3.0F }, floats_t{ 4.0F, 5.0F } };
+		written = 0;
+		auto aligned_read = std::vector<floats_t>( );
+		writer.write( aligned ).then( [&]( auto result ) { written = result.get( ); } );
+		reader.read<std::vector<floats_t>>( ).then( [&]( auto result ) {
+			aligned_read = result.get( );
+		} );
+		loop.run( );
+		assert( written == daw::burp::calc_size( aligned ) + 8 );
+		assert( aligned_read.size( ) == 2 and aligned_read[1].size( ) == 2 );
+		assert( aligned_read[1][1] == 5.0F );
+		::close( sockets[0] );
+		bool is_closed_error = false;
+		reader.read<int>( ).then( [&]( auto result ) {
+			try {
+				(void)result.get( );
+			} catch( daw::burp::ErrorReason e ) {
+				is_closed_error = e == daw::burp::ErrorReason::InputError;
+			}
+		} );
+		loop.run( );
+		assert( is_closed_error );
+		::close( sockets[1] );
+	}
+	{
+		// Writing to a socket whose peer has closed fails the write rather than raising SIGPIPE
+		int sockets[2];
+		int const pair_result = ::socketpair( AF_UNIX, SOCK_STREAM, 0, sockets );
+		assert( pair_result == 0 );
+		::fcntl( sockets[0], F_SETFL, ::fcntl( sockets[0], F_GETFL ) | O_NONBLOCK );
+		::close( sockets[1] );
+		auto loop = daw::burp::event_loop( );
+		auto writer = daw::burp::async_writer( loop, sockets[0] );
+		bool is_output_error = false;
+		writer.write( std::string( "closed" ) ).then( [&]( auto result ) {
+			try {
+				(void)result.get( );
+			} catch( daw::burp::ErrorReason e ) {
+				is_output_error = e == daw::burp::ErrorReason::OutputError;
+			}
+		} );
+		loop.run( );
+		assert( is_output_error );
+		::close( sockets[0] );
+	}
+#endif
+#if defined( DAW_BURP_HAS_SEALED_SNAPSHOT )
+	{
+		auto const ys = std::vector<Y>{ Y{ { 1, 2 }, "snap" }, Y{ { 3, 4 }, "shot" } };
+		auto const snapshot = daw::burp::sealed_snapshot::create( ys );
+		assert( snapshot.size( ) == daw::burp::calc_size( ys ) );
+		// Sealed against writes
+		auto const write_result = ::write( snapshot.fd( ), "x", 1 );
+		assert( write_result < 0 );
+		{
+			auto const mapping = daw::burp::snapshot_mapping( snapshot );
+			assert( daw::burp::read<std::vector<Y>>( mapping.data( ) )[1].m1 == "shot" );
+			// Mapping leaves the file offset shared with other holders of the descriptor alone
+			auto const file_offset = ::lseek( snapshot.fd( ), 0, SEEK_CUR );
+			assert( file_offset == 0 );
+		}
+		{
+			// A value that cannot be encoded does not leak a descriptor
+			int const next_fd = ::dup( 0 );
+			::close( next_fd );
+			bool did_throw = false;
+			try {
+				(void)daw::burp::sealed_snapshot::create( static_cast<Color>( 70000 ) );
+			} catch( daw::burp::ErrorReason e ) {
+				did_throw = e == daw::burp::ErrorReason::OutputError;
+			}
+			int const after_fd = ::dup( 0 );
+			::close( after_fd );
+			assert( did_throw and after_fd == next_fd );
+		}
+		for( int subscriber = 0; subscriber < 3; ++subscriber ) {
+			int fds[2];
+			int const pipe_result = ::pipe( fds );
+			assert( pipe_result == 0 );
+			snapshot.send_to( fds[1] );
+			::close( fds[1] );
+			auto const received =
+			  daw::burp::read<std::vector<Y>>( daw::burp::concepts::fd_t( fds[0] ) );
+			assert( received.size( ) == 2 and received[0].m0.m2 == 2 );
+			::close( fds[0] );
+		}
+		{
+			int fds[2];
+			int const pipe_result = ::pipe( fds );
+			assert( pipe_result == 0 );
+			::close( fds[0] );
+			bool is_output_error = false;
+			try {
+				snapshot.send_to( fds[1] );
+			} catch( daw::burp::ErrorReason e ) {
+				is_output_error = e == daw::burp::ErrorReason::OutputError;
+			}
+			assert( is_output_error );
+			::close( fds[1] );
+		}
+	}
+#endif
+#if defined( DAW_HAS_UNISTD )
+	{
+		// One traversal written to a pipe, a string and a checksum
+		auto const ys = std::vector<Y>{ Y{ { 1, 2 }, "tee" }, Y{ { 3, 4 }, "output" } };
+		auto expected = std::string( );
+		(void)daw::burp::write( expected, ys );
+		int fds[2];
+		int const pipe_result = ::pipe( fds );
+		assert( pipe_result == 0 );
+		auto str = std::string( );
+		auto crc = daw::burp::crc32c_output{ };
+		auto fd = daw::burp::concepts::fd_t( fds[1] );
+		{
+			auto out = daw::burp::make_tee_output( fd, str, crc );
+			auto const sz = daw::burp::write( out, ys );
+			assert( sz == expected.size( ) );
+		}
+		::close( fds[1] );
+		assert( str == expected );
+		assert( crc.size == expected.size( ) );
+		assert( crc.crc == daw::burp::crc32c( 0, expected.data( ), expected.size( ) ) );
+		auto const received = daw::burp::read<std::vector<Y>>( daw::burp::concepts::fd_t( fds[0] ) );
+		assert( received.size( ) == 2 and received[1].m1 == "output" );
+		::close( fds[0] );
+	}
+#endif
+	{
+		// Decoding on several threads gives the same result as read
+		auto ys = daw::burp::indexed_container<std::vector<Y>>( );
+		for( int n = 0; n < 1000; ++n ) {
+			ys.push_back( Y{ { n, -n }, std::string( static_cast<std::size_t>( n % 37 ), 'p' ) } );
+		}
+		auto const options = daw::burp::parallel_read_options{ 4, 3 };
+		auto indexed_buff = std::string( );
+		(void)daw::burp::write( indexed_buff, ys );
+		auto const indexed = daw::burp::parallel_read<daw::burp::indexed_container<std::vector<Y>>>(
+		  daw::span<char const>( indexed_buff.data( ), indexed_buff.size( ) ), options );
+		auto plain_buff = std::string( );
+		(void)daw::burp::write( plain_buff, static_cast<std::vector<Y> const &>( ys ) );
+		auto const plain = daw::burp::parallel_read<std::vector<Y>>(
+		  daw::span<char const>( plain_buff.data( ), plain_buff.size( ) ), options );
+		auto const serial = daw::burp::read<std::vector<Y>>( std::string_view( plain_buff ) );
+		assert( indexed.size( ) == serial.size( ) and plain.size( ) == serial.size( ) );
+		for( std::size_t n = 0; n < serial.size( ); ++n ) {
+			assert( indexed[n].m0.m1 == serial[n].m0.m1 and indexed[n].m1 == serial[n].m1 );
+			assert( plain[n].m0.m2 == serial[n].m0.m2 and plain[n].m1 == serial[n].m1 );
+		}
+		bool has_error = false;
+		try {
+			(void)daw::burp::parallel_read<std::vector<Y>>(
+			  daw::span<char const>( plain_buff.data( ), plain_buff.size( ) - 1U ), options );
+		} catch( daw::burp::ErrorReason ) {
+			has_error = true;
+		}
+		assert( has_error );
+	}
+#if defined( DAW_BURP_HAS_SNAPSHOT_STORE )
+	{
+		auto const tmp = daw::unique_temp_file{ };
+		auto const path = std::string( tmp.native( ) );
+		using snapshot_t = daw::burp::indexed_container<std::vector<Y>>;
+		auto ys = snapshot_t( );
+		ys.push_back( Y{ { 1, 2 }, "saved" } );
+		ys.push_back( Y{ { 3, 4 }, "snapshot" } );
+		auto const payload_size = daw::burp::save_snapshot( path, ys, 7 );
+		assert( payload_size == daw::burp::calc_size( ys ) );
+		{
+			auto const snapshot = daw::burp::load_snapshot( path );
+			assert( snapshot.format_version( ) == 7 );
+			assert( snapshot.data( ).size( ) == payload_size );
+			snapshot.verify( );
+			auto const lazy = snapshot.view_as<snapshot_t>( );
+			assert( lazy.size( ) == 2 and lazy[1].decode( ).m1 == "snapshot" );
+			auto const eager = snapshot.read<snapshot_t>( );
+			assert( eager.size( ) == 2 and eager[0].m0.m2 == 2 );
+		}
+		// Replacing a snapshot leaves no temporary file behind
+		auto const has_temp_files = [&] {
+			auto const saved = std::filesystem::path( path );
+			auto const prefix = saved.filename( ).string( ) + ".tmp.";
+			for( auto const &entry : std::filesystem::directory_iterator( saved.parent_path( ) ) ) {
+				if( entry.path( ).filename( ).string( ).rfind( prefix, 0 ) == 0 ) {
+					return true;
+				}
+			}
+			return false;
+		};
+		ys.push_back( Y{ { 5, 6 }, "replaced" } );
+		(void)daw::burp::save_snapshot( path, ys );
+		assert( not has_temp_files( ) );
+		assert( daw::burp::load_snapshot( path ).view_as<snapshot_t>( ).size( ) == 3 );
+		// Threads saving to the same path each write their own temporary file
+		{
+			auto savers = std::vector<std::thread>( );
+			for( int t = 0; t < 4; ++t ) {
+				savers.emplace_back( [&] {
+					for( int n = 0; n < 25; ++n ) {
+						(void)daw::burp::save_snapshot( path, ys );
+					}
+				} );
+			}
+			for( auto &saver : savers ) {
+				saver.join( );
+			}
+		}
+		assert( not has_temp_files( ) );
+		daw::burp::load_snapshot( path ).verify( );
+		assert( daw::burp::load_snapshot( path ).view_as<snapshot_t>( ).size( ) == 3 );
+		// Flip a payload byte
+		int const fd = ::open( path.c_str( ), O_RDWR );
+		assert( fd >= 0 );
+		auto const pwrite_result = ::pwrite( fd, "x", 1, 72 );
+		assert( pwrite_result == 1 );
+		::close( fd );
+		bool has_checksum_error = false;
+		try {
+			daw::burp::load_snapshot( path ).verify( );
+		} catch( daw::burp::ErrorReason e ) {
+			has_checksum_error = e == daw::burp::ErrorReason::ChecksumError;
+		}
+		assert( has_checksum_error );
+		// Not a snapshot
+		{
+			auto *f = std::fopen( path.c_str( ), "wb" );
+			assert( f );
+			std::fputs( "this is not a snapshot file at all", f );
+			std::fclose( f );
+		}
+		bool has_input_error = false;
+		try {
+			(void)daw::burp::load_snapshot( path );
+		} catch( daw::burp::ErrorReason e ) {
+			has_input_error = e == daw::burp::ErrorReason::InputError;
+		}
+		assert( has_input_error );
+	}
+#endif
+	{
+		auto const previous = Checkpoint{ Y{ { 1, 2 }, "head" },
+		                                  Z{ { { "a", 1 }, { "b", 2 } } },
+		                                  std::vector<X>( 1000, X{ 3, 4 } ),
+		                                  std::nullopt,
+		                                  0.5 };
+		auto const encoded = []( Checkpoint const &c ) {
+			auto result = std::string( );
+			(void)daw::burp::write( result, c );
+			return result;
+		};
+		auto delta = std::string( );
+		auto sz = daw::burp::write_delta( delta, previous, previous );
+		assert( sz == delta.size( ) and sz == sizeof( std::uint32_t ) );
+		// Only the nested string and the double are written
+		auto current = previous;
+		current.head.m1 = "new head";
+		current.load = 0.75;
+		delta.clear( );
+		sz = daw::burp::write_delta( delta, previous, current );
+		assert( sz < 64 );
+		auto patched = previous;
+		daw::burp::apply_delta( std::string_view( delta ), patched );
+		assert( encoded( patched ) == encoded( current ) );
+		// Containers and optionals are replaced whole
+		current.samples[500].m2 = 5;
+		current.index.kv["c"] = 3;
+		current.pending = Y{ { 5, 6 }, "pending" };
+		delta.clear( );
+		(void)daw::burp::write_delta( delta, previous, current );
+		patched = previous;
+		daw::burp::apply_delta( std::string_view( delta ), patched );
+		assert( encoded( patched ) == encoded( current ) );
+		// Member indices past the last member are rejected
+		auto const bad = std::string( "\x01\0\0\0\x09\0\0\0", 8 );
+		bool has_error = false;
+		try {
+			daw::burp::apply_delta( std::string_view( bad ), patched );
+		} catch( daw::burp::ErrorReason ) {
+			has_error = true;
+		}
+		assert( has_error );
+	}
+	{
+		using series_t = daw::burp::indexed_container<std::vector<Series>>;
+		auto series = series_t( );
+		for( int n = 0; n < 5; ++n ) {
+			auto s = Series{ std::string( static_cast<std::size_t>( n * 3 ), 's' ), { }, { }, 'x' };
+			s.values.assign( static_cast<std::size_t>( n + 1 ), 1.5 * n );
+			s.weights.assign( static_cast<std::size_t>( n ), 0.25F );
+			series.push_back( s );
+		}
+		auto buff = std::string( );
+		auto const sz = daw::burp::write( buff, series );
+		assert( sz == buff.size( ) and sz == daw::burp::calc_size( series ) );
+		auto const result = daw::burp::read<series_t>( std::string_view( buff ) );
+		assert( result.size( ) == 5 and result[4].values[4] == 6.0 and result[3].weights[2] == 0.25F );
+		auto into = Series{ };
+		auto const encoded =
+		  daw::burp::container_view<series_t>( daw::span<char const>( buff.data( ), buff.size( ) ) );
+		daw::burp::read_into( encoded.element_data( 2 ), into );
+		assert( into.values.size( ) == 3 and into.tag == 'x' );
+		// Nesting indexed containers does not multiply the work of measuring them
+		using level1_t = daw::burp::indexed_container<std::vector<Counted>>;
+		using level2_t = daw::burp::indexed_container<std::vector<level1_t>>;
+		using level3_t = daw::burp::indexed_container<std::vector<level2_t>>;
+		using level4_t = daw::burp::indexed_container<std::vector<level3_t>>;
+		auto const nested = level4_t{ level3_t{ level2_t{ level1_t{ Counted{ 7 } } } } };
+		counted_visits = 0;
+		auto const nested_size = daw::burp::calc_size( nested );
+		assert( counted_visits == 1 );
+		auto nested_buff = std::string( );
+		counted_visits = 0;
+		auto const nested_written = daw::burp::write( nested_buff, nested );
+		// calc_size, then a measurement for each level and the element itself
+		assert( counted_visits == 6 );
+		assert( nested_written == nested_size and nested_buff.size( ) == nested_size );
+		auto const nested_read = daw::burp::read<level4_t>( std::string_view( nested_buff ) );
+		assert( nested_read[0][0][0][0].value == 7 );
+#if defined( DAW_BURP_HAS_SNAPSHOT_STORE )
+		// The elements are aligned in place in a mapped snapshot
+		auto const tmp = daw::unique_temp_file{ };
+		auto const path = std::string( tmp.native( ) );
+		(void)daw::burp::save_snapshot( path, series );
+		auto const snapshot = daw::burp::load_snapshot( path );
+		auto const view = snapshot.view_as<series_t>( );
+		for( std::size_t n = 0; n < view.size( ); ++n ) {
+			auto const values = view[n].get<1>( ).values( );
+			auto const weights = view[n].get<2>( ).values( );
+			assert( reinterpret_cast<std::uintptr_t>( values.data( ) ) % 64U == 0 );
+			assert( reinterpret_cast<std::uintptr_t>( weights.data( ) ) % 16U == 0 );
+			assert( values.size( ) == n + 1U and weights.size( ) == n );
+			assert( view[n].get<3>( ) == 'x' );
+		}
+#endif
+	}
+	{
+		// Corrupt counts fail with InputError instead of allocating what they claim
+		auto const is_input_error = []( auto const &read_corrupt ) {
+			try {
+				read_corrupt( );
+			} catch( daw::burp::ErrorReason e ) {
+				return e == daw::burp::ErrorReason::InputError;
+			}
+			return false;
+		};
+		auto const bogus = std::string( 8, '\x7f' );
+		assert( is_input_error( [&] {
+			(void)daw::burp::read<std::vector<std::string>>( std::string_view( bogus ) );
+		} ) );
+		// A count of 2^40 followed by a few bytes, from inputs that cannot be checked up front
+		auto const huge = std::string( "\0\0\0\0\0\x01\0\0abcdefgh", 16 );
+		assert( is_input_error( [&] {
+			auto ss = std::stringstream( huge );
+			(void)daw::burp::read<std::vector<std::string>>( ss );
+		} ) );
+		assert( is_input_error( [&] {
+			auto ss = std::stringstream( huge );
+			(void)daw::burp::read<std::vector<int>>( ss );
+		} ) );
+		assert( is_input_error( [&] {
+			auto ss = std::stringstream( huge );
+			(void)daw::burp::read<std::deque<char>>( ss );
+		} ) );
+		assert( is_input_error( [&] {
+			auto ss = std::stringstream( huge );
+			auto value = std::vector<Y>( 3 );
+			daw::burp::read_into( ss, value );
+		} ) );
+		// Valid inputs larger than the unchecked reserve still read from streams
+		auto const large = std::vector<int>( 1'000'000, 7 );
+		auto ss = std::stringstream( );
+		daw::burp::write( ss, large );
+		assert( daw::burp::read<std::vector<int>>( ss ) == large );
+	}
+#if defined( DAW_BURP_HAS_SNAPSHOT_STORE )
+	{
+		auto const tmps = std::vector<daw::unique_temp_file>( 4 );
+		auto paths = std::vector<std::string>( );
+		for( std::size_t n = 0; n < 3; ++n ) {
+			paths.emplace_back( tmps[n].native( ) );
+		}
+		auto const manifest_path = std::string( tmps[3].native( ) );
+		auto values = std::vector<Y>( );
+		for( int n = 0; n < 100; ++n ) {
+			values.push_back( Y{ { n, n * 2 }, std::string( static_cast<std::size_t>( n ), 'y' ) } );
+		}
+		auto const manifest = daw::burp::write_sharded( values, paths, manifest_path );
+		assert( manifest.element_count == 100 and manifest.shards.size( ) == 3 );
+		assert( manifest.shards[1].first == 33 and manifest.shards[2].count == 34 );
+		auto const result = daw::burp::read_sharded<std::vector<Y>>( manifest_path );
+		assert( result.size( ) == 100 and result[99].m0.m2 == 198 and result[50].m1.size( ) == 50 );
+		auto buff = std::string( );
+		auto const sz = daw::burp::write( buff, result );
+		auto expected = std::string( );
+		(void)daw::burp::write( expected, values );
+		assert( sz == expected.size( ) and buff == expected );
+
+		// Forward only containers are split with their iterators, and more shards than elements
+		// leaves some empty
+		auto const names = std::list<std::string>{ "a", "bb" };
+		(void)daw::burp::write_sharded( names, paths, manifest_path );
+		auto const read_names = daw::burp::read_sharded<std::vector<std::string>>( manifest_path );
+		assert( read_names.size( ) == 2 and read_names[0] == "a" and read_names[1] == "bb" );
+
+		// A shard that does not match the manifest is rejected
+		(void)daw::burp::write_sharded( values, paths, manifest_path );
+		int const fd = ::open( paths[1].c_str( ), O_WRONLY | O_TRUNC );
+		assert( fd >= 0 );
+		::close( fd );
+		bool has_error = false;
+		try {
+			(void)daw::burp::read_sharded<std::vector<Y>>( manifest_path );
+		} catch( daw::burp::ErrorReason ) {
+			has_error = true;
+		}
+		assert( has_error );
+	}
+#endif
 }